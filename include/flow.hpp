@@ -12,18 +12,23 @@
 
 #include <flow/op/all_any_none.hpp>
 #include <flow/op/cartesian_product.hpp>
+#include <flow/op/cartesian_product_tiled.hpp>
 #include <flow/op/cartesian_product_with.hpp>
 #include <flow/op/chain.hpp>
 #include <flow/op/chunk.hpp>
 #include <flow/op/collect.hpp>
+#include <flow/op/combinations.hpp>
 #include <flow/op/contains.hpp>
 #include <flow/op/count.hpp>
 #include <flow/op/count_if.hpp>
 #include <flow/op/cycle.hpp>
+#include <flow/op/dedup.hpp>
 #include <flow/op/deref.hpp>
+#include <flow/op/distinct.hpp>
 #include <flow/op/drop.hpp>
 #include <flow/op/drop_while.hpp>
 #include <flow/op/equal.hpp>
+#include <flow/op/fanout.hpp>
 #include <flow/op/filter.hpp>
 #include <flow/op/find.hpp>
 #include <flow/op/flatten.hpp>
@@ -33,36 +38,53 @@
 #include <flow/op/inspect.hpp>
 #include <flow/op/interleave.hpp>
 #include <flow/op/is_sorted.hpp>
+#include <flow/op/join.hpp>
 #include <flow/op/map.hpp>
+#include <flow/op/map_filter.hpp>
 #include <flow/op/map_refinements.hpp>
+#include <flow/op/merge.hpp>
 #include <flow/op/minmax.hpp>
 #include <flow/op/output_to.hpp>
+#include <flow/op/probe.hpp>
 #include <flow/op/product.hpp>
 #include <flow/op/reverse.hpp>
 #include <flow/op/scan.hpp>
+#include <flow/op/set_operations.hpp>
+#include <flow/op/sketches.hpp>
 #include <flow/op/slide.hpp>
+#include <flow/op/sorted.hpp>
+#include <flow/op/spawn_stage.hpp>
 #include <flow/op/split.hpp>
 #include <flow/op/stride.hpp>
 #include <flow/op/sum.hpp>
 #include <flow/op/take.hpp>
 #include <flow/op/take_while.hpp>
+#include <flow/op/tee.hpp>
 #include <flow/op/to.hpp>
 #include <flow/op/to_range.hpp>
 #include <flow/op/try_fold.hpp>
 #include <flow/op/try_for_each.hpp>
+#include <flow/op/write_buffered.hpp>
 #include <flow/op/write_to.hpp>
 #include <flow/op/zip.hpp>
 #include <flow/op/zip_with.hpp>
 
 #include <flow/source/any_flow.hpp>
 #include <flow/source/async.hpp>
+#include <flow/source/async_flow.hpp>
 #include <flow/source/c_str.hpp>
+#include <flow/source/channel.hpp>
+#include <flow/source/compressed.hpp>
 #include <flow/source/empty.hpp>
 #include <flow/source/from.hpp>
+#include <flow/source/from_chars.hpp>
+#include <flow/source/from_columns.hpp>
+#include <flow/source/from_lines.hpp>
 #include <flow/source/generate.hpp>
 #include <flow/source/iota.hpp>
 #include <flow/source/istream.hpp>
 #include <flow/source/istreambuf.hpp>
 #include <flow/source/of.hpp>
+#include <flow/source/prefetch.hpp>
 
 #endif
@@ -0,0 +1,196 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_CORE_CHAR_WINDOW_HPP_INCLUDED
+#define FLOW_CORE_CHAR_WINDOW_HPP_INCLUDED
+
+#include <flow/core/macros.hpp>
+#include <flow/core/type_traits.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flow::detail {
+
+inline constexpr std::size_t read_block_size = 64 * 1024;
+
+// Readers supply characters in blocks, via read(char*, size_t) -> size_t,
+// which returns zero at end of input
+
+struct streambuf_reader {
+    std::streambuf* buf;
+
+    auto read(char* dest, std::size_t len) -> std::size_t
+    {
+        const auto n = buf->sgetn(dest, static_cast<std::streamsize>(len));
+        return n > 0 ? static_cast<std::size_t>(n) : 0;
+    }
+};
+
+struct file_reader {
+    std::FILE* file;
+
+    auto read(char* dest, std::size_t len) -> std::size_t
+    {
+        return std::fread(dest, 1, len, file);
+    }
+};
+
+// A flow whose items are chunks of characters, such as std::string_views
+template <typename F, typename = void>
+inline constexpr bool is_chunk_flow = false;
+
+template <typename F>
+inline constexpr bool is_chunk_flow<F, std::enable_if_t<is_flow<F>>> =
+    std::is_convertible_v<item_t<F>, std::string_view>;
+
+// Reads from a chunk flow
+template <typename Flow>
+struct chunk_reader {
+    Flow flow;
+    std::string_view chunk{};
+
+    auto read(char* dest, std::size_t len) -> std::size_t
+    {
+        while (chunk.empty()) {
+            auto m = flow.next();
+            if (!m) {
+                return 0;
+            }
+            chunk = std::string_view(*m);
+        }
+        const std::size_t n = len < chunk.size() ? len : chunk.size();
+        std::memcpy(dest, chunk.data(), n);
+        chunk.remove_prefix(n);
+        return n;
+    }
+};
+
+// Used when all of the input is available up front
+struct no_reader {
+    auto read(char*, std::size_t) -> std::size_t { return 0; }
+};
+
+// Copies from characters already in memory, for sources which cannot use
+// them in place
+struct string_reader {
+    std::string_view chars;
+
+    auto read(char* dest, std::size_t len) -> std::size_t
+    {
+        const std::size_t n = len < chars.size() ? len : chars.size();
+        std::memcpy(dest, chars.data(), n);
+        chars.remove_prefix(n);
+        return n;
+    }
+};
+
+// Returns a reader for any of the kinds of character source we accept
+
+inline auto make_reader(std::string_view chars) -> string_reader
+{
+    return {chars};
+}
+
+// The reader would refer to a destroyed string
+template <typename Traits, typename Alloc>
+auto make_reader(std::basic_string<char, Traits, Alloc>&&) -> string_reader = delete;
+
+inline auto make_reader(std::streambuf* buf) -> streambuf_reader
+{
+    return {buf};
+}
+
+inline auto make_reader(std::istream& is) -> streambuf_reader
+{
+    return {is.rdbuf()};
+}
+
+inline auto make_reader(std::FILE* file) -> file_reader
+{
+    return {file};
+}
+
+template <typename Flow, std::enable_if_t<is_chunk_flow<Flow>, int> = 0>
+auto make_reader(Flow flow) -> chunk_reader<Flow>
+{
+    return {std::move(flow)};
+}
+
+// A window onto the characters which have not yet been consumed, which is
+// refilled from a reader as necessary
+template <typename Reader>
+struct char_window {
+
+    static constexpr bool is_buffered = !std::is_same_v<Reader, no_reader>;
+
+    explicit char_window(std::string_view chars)
+        : chars_(chars)
+    {}
+
+    explicit char_window(Reader reader)
+        : reader_(std::move(reader)),
+          buf_(read_block_size),
+          at_end_(false)
+    {}
+
+    [[nodiscard]] auto begin() const -> const char* { return chars_.data(); }
+    [[nodiscard]] auto end() const -> const char* { return chars_.data() + chars_.size(); }
+
+    // True once the reader has been exhausted, so that the window holds all
+    // of the remaining input
+    [[nodiscard]] auto at_end() const -> bool { return at_end_; }
+
+    void consume_to(const char* pos)
+    {
+        chars_.remove_prefix(static_cast<std::size_t>(pos - begin()));
+    }
+
+    void clear()
+    {
+        chars_ = {};
+        at_end_ = true;
+    }
+
+    // Moves the unconsumed characters to the front of the buffer (growing it
+    // if they already fill it) and reads more after them. Returns false at
+    // end of input.
+    auto refill() -> bool
+    {
+        if constexpr (is_buffered) {
+            if (at_end_) {
+                return false;
+            }
+            const std::size_t len = chars_.size();
+            std::memmove(buf_.data(), chars_.data(), len);
+            if (len == buf_.size()) {
+                buf_.resize(buf_.size() * 2);
+            }
+            const std::size_t n = reader_.read(buf_.data() + len, buf_.size() - len);
+            chars_ = std::string_view(buf_.data(), len + n);
+            at_end_ = (n == 0);
+            return n > 0;
+        } else {
+            return false;
+        }
+    }
+
+private:
+    FLOW_NO_UNIQUE_ADDRESS Reader reader_{};
+    std::vector<char> buf_;
+    std::string_view chars_;
+    bool at_end_ = true;
+};
+
+}
+
+#endif
@@ -14,12 +14,38 @@
 #include <flow/source/from.hpp>
 
 #include <cassert>
+#include <cstdio>  // for write_buffered()
 #include <iosfwd>  // for stream_to()
 #include <string>  // for to_string()
+#include <string_view> // for probe()
 #include <vector>  // for to_vector()
 
 namespace flow {
 
+namespace detail {
+
+// Operations which apply one of the built-in predicates to a contiguous flow
+// of arithmetic values can evaluate it over fixed-size batches of items with
+// no branches inside each batch, which compilers are able to vectorise
+template <typename F, typename Pred>
+inline constexpr bool can_batch_predicate =
+    pred::is_pure_predicate<Pred> && is_contiguous_flow<F> &&
+    std::is_arithmetic_v<value_t<F>>;
+
+inline constexpr dist_t predicate_batch_size = 64;
+
+}
+
+/// What `flow_base::tee()` should do when one reader gets too far ahead of
+/// the slowest reader
+enum class tee_policy {
+    /// Wait for the slowest reader to catch up. This requires that the
+    /// readers are used from separate threads.
+    block,
+    /// Let the buffer grow beyond its nominal maximum
+    spill
+};
+
 template <typename Derived>
 struct flow_base {
 
@@ -154,11 +180,31 @@ public:
     template <typename Func>
     constexpr auto for_each(Func func) -> Func;
 
+    /// Exhausts the flow, pushing each item to every one of `sinks` in a
+    /// single pass.
+    ///
+    /// The sinks are created by the functions in namespace `flow::sink`, and
+    /// mirror the terminal operations of the same names, for example
+    /// `sink::sum()`, `sink::minmax()`, `sink::count_if(pred)` and
+    /// `sink::to_vector()`. Sinks may be composed using `sink::map()`,
+    /// `sink::filter()` and (nested) `sink::fanout()`. Items are passed to
+    /// each sink as lvalues, so sinks which store items take copies.
+    ///
+    /// @param sinks The sinks to feed
+    /// @returns A `std::tuple` containing the result of each sink, in order
+    template <typename... Sinks>
+    constexpr auto fanout(Sinks... sinks);
+
     /// Exhausts the flow, returning the number of items for which `pred`
     /// returned true
     ///
     /// Equivalent to `filter(pred).count()`.
     ///
+    /// If `pred` is one of the built-in predicates from `flow::pred` (or a
+    /// combination of them) and this flow is a contiguous flow of arithmetic
+    /// values, the items are tested in a simple loop which the compiler can
+    /// vectorise.
+    ///
     /// @param pred A predicate accepting the flow's item type
     /// @returns The number of items for which the `pred(item)` returned true
     template <typename Pred>
@@ -253,6 +299,11 @@ public:
     ///
     /// Unlike most operations, this function is short-circuiting. It will stop
     /// processing the flow when an item fails to satisfy the predicate.
+    ///
+    /// If `pred` is one of the built-in predicates from `flow::pred` (or a
+    /// combination of them) and this flow is a contiguous flow of arithmetic
+    /// values, the items are tested in batches without branching, which
+    /// the compiler can vectorise. The same applies to `any()` and `none()`.
     template <typename Pred>
     constexpr auto all(Pred pred) -> bool;
 
@@ -282,6 +333,99 @@ public:
     template <typename Cmp = less>
     constexpr auto is_sorted(Cmp cmp = Cmp{}) -> bool;
 
+    /// Exhausts the flow, returning a `std::vector` containing its items
+    /// sorted according to `cmp`.
+    ///
+    /// If the flow is sized, the vector is allocated up-front. Integral items
+    /// compared with `less` or `greater` are sorted using a radix sort;
+    /// otherwise, this uses `std::sort()`.
+    ///
+    /// @param cmp Comparator to use, defaulting to `flow::less`
+    /// @return A new sorted `std::vector<value_t<Flow>>`
+    template <typename Cmp = less>
+    auto sorted(Cmp cmp = Cmp{}) &&;
+
+    /// Exhausts the flow, returning a `std::vector` containing its items
+    /// sorted according to `cmp`, using several threads.
+    ///
+    /// The items are collected as for `sorted()`. Large inputs are then split
+    /// into one chunk per hardware thread, and each chunk is sorted with
+    /// `std::sort()` on its own thread. The sorted chunks are merged pairwise,
+    /// also in parallel. Small inputs, and integral items which `sorted()`
+    /// would radix sort, are sorted on the calling thread as by `sorted()`.
+    ///
+    /// `cmp` is called from several threads at once, so it must be safe to
+    /// call concurrently. If it throws, the exception is rethrown once all
+    /// threads have finished.
+    ///
+    /// @param cmp Comparator to use, defaulting to `flow::less`
+    /// @return A new sorted `std::vector<value_t<Flow>>`
+    template <typename Cmp = less>
+    auto par_sorted(Cmp cmp = Cmp{}) &&;
+
+    /// Exhausts the flow, returning a `std::vector` of (at most) `k` items
+    /// which would appear first if the flow were sorted according to `cmp`.
+    ///
+    /// Use `std::greater<>` as the comparator to select the `k` largest items.
+    ///
+    /// Items are processed one at a time using a bounded heap, so this
+    /// requires only `O(k)` memory and runs in `O(n log k)` time. It may be
+    /// used with single-pass flows.
+    ///
+    /// @param k Number of items to keep. Must be non-negative.
+    /// @param cmp Comparator to use, defaulting to `flow::less`
+    /// @return A `std::vector` of at most `k` items, sorted according to `cmp`
+    template <typename Cmp = less>
+    auto top_k(dist_t k, Cmp cmp = Cmp{});
+
+    /// Exhausts the flow, returning the item which would be at (zero-based)
+    /// position `n` if the flow were sorted according to `cmp`.
+    ///
+    /// If the flow has `n` items or fewer, returns an empty `maybe`.
+    ///
+    /// This uses top_k() internally, and so requires `O(n)` memory.
+    ///
+    /// @param n Index of the item to return. Must be non-negative.
+    /// @param cmp Comparator to use, defaulting to `flow::less`
+    /// @return The `n`th item in sorted order, wrapped in a `flow::maybe`
+    template <typename Cmp = less>
+    auto nth_element(dist_t n, Cmp cmp = Cmp{});
+
+    /// Exhausts the flow, returning an estimate of the number of distinct
+    /// items it contained, using a HyperLogLog sketch.
+    ///
+    /// Memory use is fixed at `2^precision` bytes. The relative standard error
+    /// is about `1.04/sqrt(2^precision)`, or 1.6% for the default precision.
+    ///
+    /// @param precision The base-2 logarithm of the number of registers to use,
+    ///                  between 4 and 18
+    /// @return The estimated number of distinct items
+    auto approx_count_distinct(int precision = 12) -> dist_t;
+
+    /// Exhausts the flow, returning a `flow::kll_sketch` which can be queried
+    /// for approximate quantiles of the items, for example
+    /// `approx_quantiles().quantile(0.99)`.
+    ///
+    /// The sketch holds `O(k)` items however long the flow, and estimates
+    /// ranks with an error of roughly `1.7/k`.
+    ///
+    /// @param k Accuracy parameter, defaulting to 200
+    /// @param cmp Comparator to use, defaulting to `flow::less`
+    /// @return A new `kll_sketch<value_t<Flow>>`
+    template <typename Cmp = less>
+    auto approx_quantiles(int k = 200, Cmp cmp = Cmp{});
+
+    /// Exhausts the flow, returning the (approximately) most frequent items,
+    /// found using the Space-Saving algorithm with `k` counters.
+    ///
+    /// Every item which makes up more than `1/k` of the flow is guaranteed
+    /// to be reported.
+    ///
+    /// @param k The number of counters to use
+    /// @return A `std::vector` of (at most) `k` `flow::heavy_hitter`s, most
+    ///         frequent first
+    auto heavy_hitters(std::size_t k);
+
     /// Processes the flows, returning true if both flows contain equal items
     /// (according to `cmp`), and both flows end at the same time.
     ///
@@ -319,6 +463,10 @@ public:
     ///
     /// It is equivalent to C++20 `std::views::transform`.
     ///
+    /// When called on the result of another `map()` or `filter()`, the two
+    /// are fused into a single adaptor, so long chains of these operations
+    /// do not produce deeply nested types.
+    ///
     /// @param func A callable with signature compatible with `(item_t<F>) -> R`
     /// @return A new flow whose item type is `R`, the return type of `func`
     template <typename Func>
@@ -400,14 +548,128 @@ public:
     template <typename Func>
     constexpr auto inspect(Func func) &&;
 
+    /// Records statistics about the items passing this point in a pipeline,
+    /// under the given stage name.
+    ///
+    /// When the library is built with `FLOW_INSTRUMENTED` defined, the number
+    /// of calls to `next()`, the number of items yielded and a sampled
+    /// estimate of the time spent in `next()` are recorded in
+    /// `flow::probe_registry::instance()`, which can write them out as JSON
+    /// or in the Chrome trace event format. If there is another probe further
+    /// upstream, the fraction of its items which reach this probe (for
+    /// example, the selectivity of a filter between the two) is reported too.
+    ///
+    /// Otherwise, this function simply returns the flow unchanged, so probes
+    /// may be left in production code at no cost.
+    ///
+    /// @param name The name of this pipeline stage
+    /// @return A new probe adaptor, or this flow (by value) if instrumentation
+    ///         is disabled
+#ifdef FLOW_INSTRUMENTED
+    constexpr auto probe(std::string_view name) &&;
+#else
+    constexpr auto probe(std::string_view name) && -> Derived;
+#endif
+
+    /// Consumes the flow, returning a new flow whose items are produced by
+    /// running this flow on a separate thread.
+    ///
+    /// This marks a pipeline stage boundary: everything upstream runs on its
+    /// own thread, pushing owned copies of its items (`value_t<Flow>`) into a
+    /// bounded buffer, while everything downstream pulls from the buffer on
+    /// the calling thread. The upstream thread is started immediately.
+    ///
+    /// An exception thrown upstream is rethrown from the downstream call to
+    /// `next()` once the items produced before it have been received. If the
+    /// returned flow is destroyed before it is exhausted (for example
+    /// because `take()` or `any()` stopped early), the upstream thread is
+    /// cancelled at its next attempt to push and then joined.
+    ///
+    /// While the buffer is full, the upstream thread spins briefly and then
+    /// blocks, so a stage whose consumer pauses does not keep a core busy.
+    ///
+    /// @param buffer_size The capacity of the buffer between the two stages
+    /// @return A new spawn_stage adaptor
+    auto spawn_stage(std::size_t buffer_size = 1024) &&;
+
+    /// Consumes the flow, returning `n` flows which each yield all of its
+    /// items.
+    ///
+    /// The readers share a single buffer, which holds just those items which
+    /// have been pulled from this flow but not yet yielded by every reader.
+    /// Readers yield owned copies (`value_t<Flow>`), except that the last
+    /// reader to reach an item takes it from the buffer by move. A reader
+    /// which is destroyed no longer holds items in the buffer. Readers may be
+    /// used from different threads.
+    ///
+    /// When a reader needs a new item and the buffer already holds
+    /// `max_buffered` items, the behaviour depends on `policy`: with
+    /// `tee_policy::spill` (the default) the buffer simply grows; with
+    /// `tee_policy::block` the reader waits until the slowest reader has
+    /// caught up, which bounds memory use but will deadlock if the readers
+    /// are consumed one after another on the same thread.
+    ///
+    /// @param n The number of readers to create
+    /// @param policy What to do when the buffer is full
+    /// @param max_buffered The nominal maximum number of buffered items
+    /// @return A `std::vector` of `n` tee adaptors
+    auto tee(std::size_t n, tee_policy policy = tee_policy::spill,
+             std::size_t max_buffered = 1024) &&;
+
     /// Consumes the flow, returning a new flow containing only those items for
     /// which `pred(item)` returned `true`.
     ///
+    /// As with `map()`, consecutive calls to `map()` and `filter()` are fused
+    /// into a single adaptor.
+    ///
     /// @param pred Predicate with signature compatible with `(const item_t<F>&) -> bool`
     /// @return A new filter adaptor.
     template <typename Pred>
     constexpr auto filter(Pred pred) &&;
 
+    /// Consumes the flow, returning a new flow which skips items whose key
+    /// compares equal to that of the item immediately before.
+    ///
+    /// This adaptor never allocates. Only consecutive duplicates are removed;
+    /// to remove all duplicates, use `distinct()`, or sort the flow first.
+    ///
+    /// @param key Callable with signature compatible with `(const item_t<F>&) -> K`,
+    ///            where `K` is equality comparable. Defaults to `flow::identity`.
+    /// @return A new dedup adaptor
+    template <typename Key = identity>
+    constexpr auto dedup(Key key = Key{}) &&;
+
+    /// Consumes the flow, returning a new flow which yields only the first
+    /// item with any given key.
+    ///
+    /// Keys which have been seen are stored in an open-addressing hash set,
+    /// so memory use grows with the number of distinct keys.
+    ///
+    /// @param key Callable with signature compatible with `(const item_t<F>&) -> K`,
+    ///            where `K` is hashable with `std::hash`. Defaults to `flow::identity`.
+    /// @return A new distinct adaptor
+    template <typename Key = identity>
+    auto distinct(Key key = Key{}) &&;
+
+    /// Consumes the flow, returning a new flow which yields (approximately) only
+    /// the first item with any given key, using a fixed amount of memory.
+    ///
+    /// Seen keys are recorded in a Bloom filter of `num_bytes` bytes. The
+    /// adaptor never yields an item with a key it has already yielded, but
+    /// may wrongly drop an item whose key has not been seen before. The
+    /// probability of this rises as the filter fills up; as a rule of thumb,
+    /// allow at least one byte per distinct key.
+    ///
+    /// This is suitable for unbounded flows, where `distinct()` would
+    /// eventually exhaust memory.
+    ///
+    /// @param num_bytes The size of the filter
+    /// @param key Callable with signature compatible with `(const item_t<F>&) -> K`,
+    ///            where `K` is hashable with `std::hash`. Defaults to `flow::identity`.
+    /// @return A new distinct_approx adaptor
+    template <typename Key = identity>
+    auto distinct_approx(std::size_t num_bytes, Key key = Key{}) &&;
+
     /// Consumes the flow, returning an adaptor which dereferences each item
     /// using unary `operator*`.
     ///
@@ -512,6 +774,123 @@ public:
     template <typename... Flowables>
     constexpr auto chain(Flowables&&... flowables) &&;
 
+    /// Given a comparator and a set of flows, each of which is sorted according
+    /// to `cmp`, returns a new flow which yields the items of all the flows
+    /// in sorted order.
+    ///
+    /// The merge is stable: if items from several flows compare equal, the
+    /// item from the earliest flow is processed first. The adaptor is
+    /// exhausted once all of the flows are exhausted.
+    ///
+    /// To merge a number of flows which is only known at run-time, see
+    /// `flow::merge_all()`.
+    ///
+    /// @note All flows passed to `merge` must have the exact same item type
+    ///
+    /// @param cmp Comparator according to which all the flows are sorted
+    /// @param flowables A list of Flowable objects to merge
+    /// @return A new merge adaptor
+    template <typename Cmp, typename... Flowables>
+    constexpr auto merge(Cmp cmp, Flowables&&... flowables) &&;
+
+    /// Given a flow which is sorted according to `cmp`, returns an adaptor
+    /// which yields the sorted union of this flow and `other`.
+    ///
+    /// As with `std::set_union`, if an item appears `m` times in this flow
+    /// and `n` times in `other`, it appears `max(m, n)` times in the output.
+    ///
+    /// @note Both flows must have the exact same item type
+    ///
+    /// @param other A Flowable object which is sorted according to `cmp`
+    /// @param cmp Comparator to use, defaulting to `flow::less`
+    /// @return A new set_union adaptor
+    template <typename Flowable, typename Cmp = less>
+    constexpr auto set_union(Flowable&& other, Cmp cmp = Cmp{}) &&;
+
+    /// Given a flow which is sorted according to `cmp`, returns an adaptor
+    /// which yields those items of this flow which also appear in `other`.
+    ///
+    /// If either flow is random-access, runs of non-matching items in that
+    /// flow are skipped using a galloping search rather than one at a time.
+    ///
+    /// @param other A Flowable object which is sorted according to `cmp`
+    /// @param cmp Comparator to use, defaulting to `flow::less`
+    /// @return A new set_intersection adaptor
+    template <typename Flowable, typename Cmp = less>
+    constexpr auto set_intersection(Flowable&& other, Cmp cmp = Cmp{}) &&;
+
+    /// Given a flow which is sorted according to `cmp`, returns an adaptor
+    /// which yields those items of this flow which do not appear in `other`.
+    ///
+    /// If `other` is random-access, runs of items which are smaller than the
+    /// current item of this flow are skipped using a galloping search.
+    ///
+    /// @param other A Flowable object which is sorted according to `cmp`
+    /// @param cmp Comparator to use, defaulting to `flow::less`
+    /// @return A new set_difference adaptor
+    template <typename Flowable, typename Cmp = less>
+    constexpr auto set_difference(Flowable&& other, Cmp cmp = Cmp{}) &&;
+
+    /// Consumes the flow, returning an adaptor which pairs each item with
+    /// every item of `other` which has an equal key.
+    ///
+    /// The first time `next()` is called, `other` is read in its entirety
+    /// into an open-addressing hash table. Items of this flow are then
+    /// streamed lazily, so this flow may be arbitrarily long (or infinite).
+    /// Use the smaller of the two flows as `other`.
+    ///
+    /// For each item of this flow, matches are yielded in the order in which
+    /// they appeared in `other`.
+    ///
+    /// @param other A finite Flowable object
+    /// @param probe_key Key function for items of this flow
+    /// @param build_key Key function for items of `other`. Its (decayed)
+    ///                  result type must be hashable with `std::hash`
+    /// @return A new flow whose item type is a `std::pair`, whose second
+    ///         member is a const reference to the stored item of `other`
+    template <typename Flowable, typename ProbeKey, typename BuildKey>
+    auto hash_join(Flowable&& other, ProbeKey probe_key, BuildKey build_key) &&;
+
+    /// Consumes the flow, returning an adaptor which yields only those items
+    /// whose key matches that of at least one item of `other`.
+    ///
+    /// Each item is yielded at most once. Only the keys of `other` are stored.
+    ///
+    /// @param other A finite Flowable object
+    /// @param probe_key Key function for items of this flow
+    /// @param build_key Key function for items of `other`
+    /// @return A new semi_join adaptor
+    template <typename Flowable, typename ProbeKey, typename BuildKey>
+    auto semi_join(Flowable&& other, ProbeKey probe_key, BuildKey build_key) &&;
+
+    /// Consumes the flow, returning an adaptor which yields only those items
+    /// whose key does not match that of any item of `other`.
+    ///
+    /// @param other A finite Flowable object
+    /// @param probe_key Key function for items of this flow
+    /// @param build_key Key function for items of `other`
+    /// @return A new anti_join adaptor
+    template <typename Flowable, typename ProbeKey, typename BuildKey>
+    auto anti_join(Flowable&& other, ProbeKey probe_key, BuildKey build_key) &&;
+
+    /// Given this flow and `other`, both sorted by key according to `cmp`,
+    /// returns an adaptor which pairs each item with every item of `other`
+    /// which has an equivalent key.
+    ///
+    /// Nothing is buffered: when several items of this flow share a key, the
+    /// matching run of `other` is replayed using a subflow.
+    ///
+    /// @note `other` must be multipass
+    ///
+    /// @param other A multipass Flowable object, sorted by key
+    /// @param left_key Key function for items of this flow
+    /// @param right_key Key function for items of `other`
+    /// @param cmp Comparator for keys, defaulting to `flow::less`
+    /// @return A new flow whose item type is a `std::pair`
+    template <typename Flowable, typename LeftKey, typename RightKey, typename Cmp = less>
+    constexpr auto merge_join(Flowable&& other, LeftKey left_key, RightKey right_key,
+                              Cmp cmp = Cmp{}) &&;
+
     /// Returns an adaptor which alternates an item from the first flow, followed
     /// by an item from the second flow, followed by the the next item from
     /// the first flow, and so on.
@@ -595,6 +974,69 @@ public:
     template <typename... Flowables>
     constexpr auto cartesian_product(Flowables&&... flowables) &&;
 
+    /// Like `cartesian_product_with()` for two flows, but visits the
+    /// combinations one `tile` x `tile` block at a time, so that the items
+    /// of each block stay in cache while they are combined.
+    ///
+    /// Blocks are visited in row-major order, and so are the items within
+    /// each block: with two flows of four items and a tile size of two, the
+    /// index pairs are (0,0) (0,1) (1,0) (1,1) (0,2) (0,3) (1,2) (1,3) (2,0)...
+    ///
+    /// @note Both flows must be random-access
+    ///
+    /// @param func Callable with signature compatible with `(item_t<Flow>&, item_t<Flow2>) -> R`
+    /// @param flowable A random-access flowable object
+    /// @param tile The number of items from each flow in a block
+    /// @return A new flow whose item type is `R`
+    template <typename Func, typename Flowable>
+    constexpr auto cartesian_product_tiled_with(Func func, Flowable&& flowable,
+                                                dist_t tile = 64) &&;
+
+    /// Like `cartesian_product()` for two flows, but visits the combinations
+    /// one `tile` x `tile` block at a time. See `cartesian_product_tiled_with()`.
+    ///
+    /// @param flowable A random-access flowable object
+    /// @param tile The number of items from each flow in a block
+    /// @return An adapted flow whose item type is a `std::pair`
+    template <typename Flowable>
+    constexpr auto cartesian_product_tiled(Flowable&& flowable, dist_t tile = 64) &&;
+
+    /// Consumes the flow, returning a new flow which yields each selection of
+    /// `K` distinct items, ignoring order, as a `std::pair` (when `K` is 2)
+    /// or `std::tuple`. The items of each selection appear in their order in
+    /// the original flow, and selections are ordered lexicographically by
+    /// position: `{a, b, c, d}` gives `(a,b,c) (a,b,d) (a,c,d) (b,c,d)`.
+    ///
+    /// Selections are stepped directly rather than filtered from a
+    /// `cartesian_product()`. The result knows its size, and if the original
+    /// flow is random-access then so is the result, so that it can be split
+    /// into pieces for parallel processing using `subflow()` and `advance()`.
+    ///
+    /// @note This adaptor requires a multipass, sized flow
+    ///
+    /// @tparam K The number of items in each selection
+    /// @return A new combinations adaptor
+    template <std::size_t K>
+    constexpr auto combinations() &&;
+
+    /// Equivalent to `combinations<2>()`: yields each pair of items
+    /// `(a, b)` where `a` comes before `b` in the original flow.
+    ///
+    /// @note This adaptor requires a multipass, sized flow
+    ///
+    /// @return A new combinations adaptor
+    constexpr auto pairs() &&;
+
+    /// Like `combinations()`, but yields every arrangement of each selection
+    /// of `K` distinct items: `{a, b, c}` gives `(a,b) (a,c) (b,a) (b,c) (c,a) (c,b)`.
+    ///
+    /// @note This adaptor requires a multipass, sized flow
+    ///
+    /// @tparam K The number of items in each selection
+    /// @return A new permutations adaptor
+    template <std::size_t K>
+    constexpr auto permutations() &&;
+
     /// Turns a flow into a flow-of-flows, where each inner flow ("group") is
     /// delimited by the return value of `func`.
     ///
@@ -656,6 +1098,12 @@ public:
     /// It is mostly useful to allow flows to be used with built-in range-for loops,
     /// or to pass flows to standard library algorithms.
     ///
+    /// The iterator category depends on the flow. Random-access flows yield
+    /// sized ranges with random-access iterators, so that (for example) the
+    /// parallel algorithms may be used; other multipass flows yield forward
+    /// iterators, and single-pass flows yield input iterators. Iterators refer
+    /// back to the range object, which must outlive them.
+    ///
     /// @return A new range object
     constexpr auto to_range() &&;
 
@@ -737,6 +1185,58 @@ public:
     template <typename Sep = const char*, typename CharT, typename Traits>
     constexpr auto write_to(std::basic_ostream<CharT, Traits>& os, Sep sep = ", ")
         -> std::basic_ostream<CharT, Traits>&;
+
+    /// Exhausts the flow, writing each item to the given C stream.
+    ///
+    /// This is a faster alternative to `write_to()`. Rather than going
+    /// through `operator<<`, arithmetic items are formatted with
+    /// `std::to_chars()` into a large internal buffer, which is written out
+    /// in big blocks. Floating-point values are written in their shortest
+    /// round-trip form. Characters and strings (anything convertible to
+    /// `std::string_view`) are copied as-is, and `bool`s are written as
+    /// `0` or `1`. Other item types are not supported.
+    ///
+    /// @param file The stream to write to
+    /// @param sep Separator to use, defaulting to `", "`. This is formatted
+    ///            in the same way as the items.
+    /// @returns `true` if all of the output was written successfully
+    template <typename Sep = const char*>
+    auto write_buffered(std::FILE* file, Sep sep = ", ") -> bool;
+
+    /// Exhausts the flow, writing each item to the given stream buffer.
+    ///
+    /// See the overload of `write_buffered()` taking a `std::FILE*` for
+    /// details.
+    template <typename Sep = const char*>
+    auto write_buffered(std::streambuf& buf, Sep sep = ", ") -> bool;
+
+#ifdef FLOW_HAVE_POSIX_IO
+    /// Exhausts the flow, writing each item to the given POSIX file
+    /// descriptor.
+    ///
+    /// See the overload of `write_buffered()` taking a `std::FILE*` for
+    /// details.
+    template <typename Sep = const char*>
+    auto write_buffered(int fd, Sep sep = ", ") -> bool;
+
+    /// Exhausts the flow, writing each item to the given POSIX file descriptor
+    /// using `writev()`.
+    ///
+    /// The flow's items must be chunks of characters: either lvalue
+    /// references to a type convertible to `std::string_view` (such as
+    /// `std::string`), or `std::string_view`s themselves. Items which are
+    /// lvalue references are not copied; instead, batches of them are handed
+    /// to the kernel directly, so they must outlive the call. Views returned
+    /// by value (as from `from_lines()`) may be invalidated by the next call
+    /// to `next()`, so they are copied into a staging buffer which is written
+    /// out whenever it fills up.
+    ///
+    /// @param fd The file descriptor to write to
+    /// @param sep Separator to use, defaulting to `", "`
+    /// @returns `true` if all of the output was written successfully
+    template <typename Sep = const char*>
+    auto writev_to(int fd, Sep sep = ", ") -> bool;
+#endif
 };
 
 }
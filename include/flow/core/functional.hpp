@@ -9,6 +9,7 @@
 #include <flow/core/macros.hpp>
 
 #include <memory>       // for std::addressof
+#include <utility>      // for std::as_const
 #include <type_traits>
 
 namespace flow {
@@ -134,6 +135,14 @@ struct greater_equal {
     }
 };
 
+struct identity {
+    template <typename T>
+    constexpr auto operator()(T&& t) const noexcept -> T&&
+    {
+        return FLOW_FWD(t);
+    }
+};
+
 namespace detail {
 
 // Reimplementations of std::min and std::max so we don't need to drag in <algorithm>
@@ -0,0 +1,190 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_CORE_HASH_TABLE_HPP_INCLUDED
+#define FLOW_CORE_HASH_TABLE_HPP_INCLUDED
+
+#include <flow/core/functional.hpp>
+#include <flow/core/maybe.hpp>
+#include <flow/core/macros.hpp>
+
+#include <cstdint>
+#include <functional> // for std::hash
+#include <utility>
+#include <vector>
+
+namespace flow::detail {
+
+// The finalizer from splitmix64. Standard library implementations of
+// std::hash for integers are typically the identity function, which is a
+// disaster when we take the low bits as a table index.
+constexpr auto hash_mix(std::uint64_t h) -> std::uint64_t
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+struct empty_mapped {};
+
+// An open-addressing hash table using linear probing over a single,
+// contiguous array of slots. Unlike std::unordered_map, inserting an element
+// does not perform a separate allocation, and lookups touch neighbouring
+// cache lines rather than chasing pointers.
+template <typename Key, typename Mapped = empty_mapped,
+          typename Hash = std::hash<Key>, typename Eq = equal_to>
+struct hash_table {
+private:
+    struct slot {
+        Key key;
+        FLOW_NO_UNIQUE_ADDRESS Mapped mapped;
+    };
+
+    std::vector<maybe<slot>> slots_;
+    std::size_t size_ = 0;
+    FLOW_NO_UNIQUE_ADDRESS Hash hash_;
+    FLOW_NO_UNIQUE_ADDRESS Eq eq_;
+
+    static constexpr std::size_t min_capacity = 16;
+
+    auto index_for(Key const& key) const -> std::size_t
+    {
+        return static_cast<std::size_t>(hash_mix(hash_(key))) & (slots_.size() - 1);
+    }
+
+    // Returns the index of the slot containing `key`, or of the empty slot
+    // where it should be inserted. Requires at least one empty slot.
+    auto probe(Key const& key) const -> std::size_t
+    {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t idx = index_for(key);
+        while (slots_[idx] && !invoke(eq_, slots_[idx]->key, key)) {
+            idx = (idx + 1) & mask;
+        }
+        return idx;
+    }
+
+    void rehash(std::size_t new_capacity)
+    {
+        auto old = std::move(slots_);
+        slots_ = std::vector<maybe<slot>>(new_capacity);
+        for (auto& s : old) {
+            if (s) {
+                slots_[probe(s->key)] = std::move(s);
+            }
+        }
+    }
+
+public:
+    hash_table() = default;
+
+    explicit hash_table(Hash hash, Eq eq = Eq{})
+        : hash_(std::move(hash)), eq_(std::move(eq))
+    {}
+
+    [[nodiscard]] auto size() const -> std::size_t { return size_; }
+
+    [[nodiscard]] auto empty() const -> bool { return size_ == 0; }
+
+    // Ensures that `n` elements can be held without rehashing
+    void reserve(std::size_t n)
+    {
+        std::size_t cap = min_capacity;
+        while (cap - cap/4 < n) {
+            cap *= 2;
+        }
+        if (cap > slots_.size()) {
+            rehash(cap);
+        }
+    }
+
+    // Returns a pointer to the mapped value for `key`, or nullptr if it is
+    // not present
+    auto find(Key const& key) -> Mapped*
+    {
+        if (size_ == 0) {
+            return nullptr;
+        }
+        auto& s = slots_[probe(key)];
+        return s ? std::addressof(s->mapped) : nullptr;
+    }
+
+    auto contains(Key const& key) const -> bool
+    {
+        return size_ > 0 && static_cast<bool>(slots_[probe(key)]);
+    }
+
+    // Inserts `key` with a value-initialised mapped value if it is not
+    // already present. Returns a pointer to the mapped value and whether
+    // an insertion took place.
+    template <typename K>
+    auto try_emplace(K&& key) -> std::pair<Mapped*, bool>
+    {
+        // Keep the load factor at or below 3/4
+        if ((size_ + 1) > slots_.size() - slots_.size()/4) {
+            rehash(slots_.empty() ? min_capacity : slots_.size() * 2);
+        }
+
+        auto& s = slots_[probe(key)];
+        if (s) {
+            return {std::addressof(s->mapped), false};
+        }
+        s = slot{Key(FLOW_FWD(key)), Mapped{}};
+        ++size_;
+        return {std::addressof(s->mapped), true};
+    }
+
+    // Returns true if `key` was newly inserted
+    template <typename K>
+    auto insert(K&& key) -> bool
+    {
+        return try_emplace(FLOW_FWD(key)).second;
+    }
+
+    // Removes `key`, returning true if it was present. Later entries in the
+    // same probe sequence are shifted back to fill the gap, so no tombstones
+    // are needed.
+    auto erase(Key const& key) -> bool
+    {
+        if (size_ == 0) {
+            return false;
+        }
+
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t hole = probe(key);
+        if (!slots_[hole]) {
+            return false;
+        }
+        slots_[hole].reset();
+        --size_;
+
+        for (std::size_t j = (hole + 1) & mask; slots_[j]; j = (j + 1) & mask) {
+            const std::size_t home = index_for(slots_[j]->key);
+            // Move the entry back unless its home lies cyclically in (hole, j]
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                slots_[hole] = std::move(slots_[j]);
+                slots_[j].reset();
+                hole = j;
+            }
+        }
+        return true;
+    }
+
+    void clear()
+    {
+        slots_.clear();
+        size_ = 0;
+    }
+};
+
+template <typename Key, typename Hash = std::hash<Key>, typename Eq = equal_to>
+using hash_set = hash_table<Key, empty_mapped, Hash, Eq>;
+
+}
+
+#endif
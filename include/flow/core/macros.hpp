@@ -36,6 +36,12 @@
 #  endif // __has_include
 #endif
 
+#if defined(__has_include)
+#  if __has_include(<unistd.h>) && __has_include(<sys/uio.h>)
+#    define FLOW_HAVE_POSIX_IO
+#  endif
+#endif
+
 #define FLOW_FWD(x) (static_cast<decltype(x)&&>(x))
 
 #define FLOW_COPY(x) (static_cast<flow::remove_cvref_t<decltype(x)>>(x))
@@ -9,9 +9,44 @@
 #include <flow/core/functional.hpp>
 
 #include <exception>
+#include <string_view>
 
 namespace flow {
 
+/// Customisation point allowing `maybe<T>` to represent the empty state
+/// using an otherwise-invalid value of `T`, rather than a separate flag.
+/// With a suitable specialisation, `sizeof(maybe<T>) == sizeof(T)`.
+///
+/// A specialisation must provide two static member functions:
+///
+///  * `empty_value()`, returning a `T` which can never be a real item
+///  * `is_empty(const T&)`, returning whether its argument is such a value
+///
+/// `T` must be copyable or movable, and both functions should be `constexpr`
+/// if `maybe<T>` is to be used in constant expressions.
+///
+/// Note that a "null" value is usually *not* a suitable choice: a flow of
+/// pointers may quite legitimately yield null items.
+template <typename T>
+struct maybe_traits {};
+
+/// `std::basic_string_view`s longer than `max_size()` cannot exist, so we
+/// use a size of `npos` to represent the empty state.
+template <typename CharT, typename Traits>
+struct maybe_traits<std::basic_string_view<CharT, Traits>> {
+    using sv_type = std::basic_string_view<CharT, Traits>;
+
+    static constexpr auto empty_value() noexcept -> sv_type
+    {
+        return sv_type(nullptr, sv_type::npos);
+    }
+
+    static constexpr auto is_empty(sv_type const& sv) noexcept -> bool
+    {
+        return sv.size() == sv_type::npos;
+    }
+};
+
 struct bad_maybe_access : std::exception {
     bad_maybe_access() = default;
 
@@ -27,6 +62,49 @@ struct in_place_t {
     constexpr explicit in_place_t() = default;
 };
 
+template <typename T, typename = void>
+inline constexpr bool has_maybe_niche = false;
+
+template <typename T>
+inline constexpr bool has_maybe_niche<T, std::void_t<
+    decltype(maybe_traits<T>::empty_value()),
+    decltype(maybe_traits<T>::is_empty(std::declval<T const&>()))>> = true;
+
+// Storage for types with a niche: the contained T is always alive, and the
+// empty state is represented by maybe_traits<T>::empty_value(). Copying,
+// moving and destruction can all just use T's own operations.
+template <typename T>
+struct maybe_niche_base {
+
+    constexpr maybe_niche_base() noexcept(noexcept(maybe_traits<T>::empty_value()))
+        : value_(maybe_traits<T>::empty_value())
+    {}
+
+    template <typename... Args>
+    constexpr maybe_niche_base(in_place_t, Args&&... args)
+        noexcept(std::is_nothrow_constructible_v<T, Args&&...>)
+        : value_(FLOW_FWD(args)...)
+    {}
+
+    constexpr void hard_reset()
+    {
+        value_ = maybe_traits<T>::empty_value();
+    }
+
+    constexpr bool has_value() const
+    {
+        return !maybe_traits<T>::is_empty(value_);
+    }
+
+    constexpr T& get() & { return value_; }
+    constexpr T const& get() const& { return value_; }
+    constexpr T&& get() && { return std::move(value_); }
+    constexpr T const&& get() const&& { return std::move(value_); }
+
+private:
+    T value_;
+};
+
 // Storage for the non-trivial case
 template <typename T, bool = std::is_trivially_destructible_v<T>>
 struct maybe_storage_base {
@@ -321,14 +399,19 @@ struct maybe_delete_assign_base<T, false, false> {
     maybe_delete_assign_base& operator=(maybe_delete_assign_base&&) = delete;
 };
 
+template <typename T>
+using maybe_base_t = std::conditional_t<has_maybe_niche<T>,
+                                        maybe_niche_base<T>,
+                                        maybe_move_assign_base<T>>;
+
 } // namespace detail
 
 template <typename T>
-class maybe : detail::maybe_move_assign_base<T>,
+class maybe : detail::maybe_base_t<T>,
               detail::maybe_delete_ctor_base<T>,
               detail::maybe_delete_assign_base<T>
 {
-    using base = detail::maybe_move_assign_base<T>;
+    using base = detail::maybe_base_t<T>;
 
 public:
     using value_type = T;
@@ -27,47 +27,110 @@ constexpr auto make_predicate(Lambda&& lambda)
     return predicate<Lambda>{FLOW_FWD(lambda)};
 }
 
+// A "pure" predicate is one of the built-in predicates (or a combination of
+// them) which is known to be cheap and free of side-effects. That means we
+// are free to evaluate it on items which we might otherwise have skipped,
+// which in turn allows evaluating it without branches -- and so lets the
+// compiler vectorise loops over arithmetic items.
+template <typename Lambda>
+struct pure_predicate : predicate<Lambda> {};
+
+template <typename Lambda>
+constexpr auto make_pure_predicate(Lambda&& lambda)
+{
+    return pure_predicate<Lambda>{{FLOW_FWD(lambda)}};
+}
+
+template <typename>
+inline constexpr bool is_pure = false;
+
+template <typename L>
+inline constexpr bool is_pure<pure_predicate<L>> = true;
+
+template <typename... Args>
+inline constexpr bool all_arithmetic =
+    (std::is_arithmetic_v<std::remove_cv_t<std::remove_reference_t<Args>>> && ...);
+
 // This could/should be a lambda, but it confuses MSVC
 template <typename Op>
 struct cmp {
     template <typename T>
     constexpr auto operator()(T&& val) const
     {
-        return predicate{[val = FLOW_FWD(val)](const auto& other) {
+        return make_pure_predicate([val = FLOW_FWD(val)](const auto& other) {
             return Op{}(other, val);
-        }};
+        });
     }
 };
 
 } // namespace detail
 
+/// Returns true if `Pred` is one of the built-in predicates in the
+/// `flow::pred` namespace, or a combination of them.
+///
+/// Such predicates have no side-effects, so operations may evaluate them in
+/// any order (or on more items than strictly necessary) in order to process
+/// contiguous arithmetic data in batches.
+template <typename Pred>
+inline constexpr bool is_pure_predicate =
+    detail::is_pure<std::remove_cv_t<std::remove_reference_t<Pred>>>;
+
 /// Given a predicate, returns a new predicate with the condition reversed
 inline constexpr auto not_ = [](auto&& pred) {
-    return detail::make_predicate([p = FLOW_FWD(pred)] (auto const&... args) {
+    auto lambda = [p = FLOW_FWD(pred)] (auto const&... args) {
         return !invoke(p, FLOW_FWD(args)...);
-    });
+    };
+    if constexpr (is_pure_predicate<decltype(pred)>) {
+        return detail::make_pure_predicate(std::move(lambda));
+    } else {
+        return detail::make_predicate(std::move(lambda));
+    }
 };
 
 /// Returns a new predicate which is satisifed only if both the given predicates
 /// return `true`.
 ///
 /// The returned predicate is short-circuiting: if the first predicate returns
-/// `false`, the second will not be evaluated.
+/// `false`, the second will not be evaluated. The exception is when both
+/// are built-in predicates and the arguments are arithmetic, in which case
+/// both are evaluated without branching.
 inline constexpr auto both = [](auto&& p, auto&& and_) {
-    return detail::predicate{[p1 = FLOW_FWD(p), p2 = FLOW_FWD(and_)] (auto const&... args) {
-        return invoke(p1, args...) && invoke(p2, args...);
-    }};
+    constexpr bool pure = is_pure_predicate<decltype(p)> && is_pure_predicate<decltype(and_)>;
+    auto lambda = [p1 = FLOW_FWD(p), p2 = FLOW_FWD(and_)] (auto const&... args) -> bool {
+        if constexpr (pure && detail::all_arithmetic<decltype(args)...>) {
+            return static_cast<bool>(invoke(p1, args...)) & static_cast<bool>(invoke(p2, args...));
+        } else {
+            return invoke(p1, args...) && invoke(p2, args...);
+        }
+    };
+    if constexpr (pure) {
+        return detail::make_pure_predicate(std::move(lambda));
+    } else {
+        return detail::make_predicate(std::move(lambda));
+    }
 };
 
 /// Returns a new predicate which is satisifed only if either of the given
 /// predicates return `true`.
 ///
 /// The returned predicate is short-circuiting: if the first predicate returns
-/// `true`, the second will not be evaluated
+/// `true`, the second will not be evaluated. The exception is when both
+/// are built-in predicates and the arguments are arithmetic, in which case
+/// both are evaluated without branching.
 inline constexpr auto either = [](auto&& p, auto&& or_) {
-     return detail::predicate{[p1 = FLOW_FWD(p), p2 = FLOW_FWD(or_)] (auto const&... args) {
-        return invoke(p1, args...) || invoke(p2, args...);
-     }};
+    constexpr bool pure = is_pure_predicate<decltype(p)> && is_pure_predicate<decltype(or_)>;
+    auto lambda = [p1 = FLOW_FWD(p), p2 = FLOW_FWD(or_)] (auto const&... args) -> bool {
+        if constexpr (pure && detail::all_arithmetic<decltype(args)...>) {
+            return static_cast<bool>(invoke(p1, args...)) | static_cast<bool>(invoke(p2, args...));
+        } else {
+            return invoke(p1, args...) || invoke(p2, args...);
+        }
+    };
+    if constexpr (pure) {
+        return detail::make_pure_predicate(std::move(lambda));
+    } else {
+        return detail::make_predicate(std::move(lambda));
+    }
 };
 
 namespace detail {
@@ -78,18 +141,36 @@ constexpr auto operator!(detail::predicate<P> pred)
     return not_(std::move(pred));
 }
 
+template <typename P>
+constexpr auto operator!(detail::pure_predicate<P> pred)
+{
+    return not_(std::move(pred));
+}
+
 template <typename L, typename R>
 constexpr auto operator&&(detail::predicate<L> lhs, detail::predicate<R> rhs)
 {
     return both(std::move(lhs), std::move(rhs));
 }
 
+template <typename L, typename R>
+constexpr auto operator&&(detail::pure_predicate<L> lhs, detail::pure_predicate<R> rhs)
+{
+    return both(std::move(lhs), std::move(rhs));
+}
+
 template <typename L, typename R>
 constexpr auto operator||(detail::predicate<L> lhs, detail::predicate<R> rhs)
 {
     return either(std::move(lhs), std::move(rhs));
 }
 
+template <typename L, typename R>
+constexpr auto operator||(detail::pure_predicate<L> lhs, detail::pure_predicate<R> rhs)
+{
+    return either(std::move(lhs), std::move(rhs));
+}
+
 }
 
 /// Returns a new predicate with is satified only if both of the given
@@ -109,34 +190,41 @@ inline constexpr auto leq = detail::cmp<flow::less_equal>{};
 inline constexpr auto geq = detail::cmp<flow::greater_equal>{};
 
 /// Returns true if the given value is greater than a zero of the same type.
-inline constexpr auto positive = detail::make_predicate([](auto const& val) -> bool {
+inline constexpr auto positive = detail::make_pure_predicate([](auto const& val) -> bool {
     return val > decltype(val){0};
 });
 
 /// Returns true if the given value is less than a zero of the same type.
-inline constexpr auto negative = detail::make_predicate([](auto const& val) -> bool {
+inline constexpr auto negative = detail::make_pure_predicate([](auto const& val) -> bool {
     return val < decltype(val){0};
 });
 
 /// Returns true if the given value is not equal to a zero of the same type.
-inline constexpr auto nonzero = detail::make_predicate([](auto const& val) -> bool {
+inline constexpr auto nonzero = detail::make_pure_predicate([](auto const& val) -> bool {
     return val != decltype(val){0};
 });
 
 /// Given a sequence of values, constructs a predicate which returns true
 /// if its argument compares equal to one of the values
+///
+/// For arithmetic arguments, all the comparisons are performed without
+/// branching.
 inline constexpr auto in = [](auto const&... vals) {
     static_assert(sizeof...(vals) > 0);
-    return detail::predicate{[vals...](auto const& arg) -> decltype(auto) {
-        return (equal_to{}(arg, vals) || ...);
-    }};
+    return detail::make_pure_predicate([vals...](auto const& arg) -> bool {
+        if constexpr (detail::all_arithmetic<decltype(arg), decltype(vals)...>) {
+            return (equal_to{}(arg, vals) | ...);
+        } else {
+            return (equal_to{}(arg, vals) || ...);
+        }
+    });
 };
 
-inline constexpr auto even = detail::make_predicate([](auto const& val) -> bool {
+inline constexpr auto even = detail::make_pure_predicate([](auto const& val) -> bool {
     return val % decltype(val){2} == decltype(val){0};
 });
 
-inline constexpr auto odd = detail::make_predicate([](auto const& val) -> bool {
+inline constexpr auto odd = detail::make_pure_predicate([](auto const& val) -> bool {
   return val % decltype(val){2} != decltype(val){0};
 });
 
@@ -0,0 +1,87 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_CORE_SPIN_WAIT_HPP_INCLUDED
+#define FLOW_CORE_SPIN_WAIT_HPP_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace flow::detail {
+
+// A place where threads wait for a condition which other threads make true.
+// Waiters spin briefly, then yield for a while, and finally block on a
+// condition variable, so that a long wait does not occupy a core.
+//
+// Whoever changes the state that a waiter's predicate reads must call
+// notify_all() afterwards. This is cheap when nobody is blocked: a fence
+// and a load of the waiter count.
+class wait_point {
+public:
+    // Waits for `pred` to return true. The predicate is never called with
+    // the internal lock held, so it may itself change state and notify.
+    template <typename Pred>
+    void wait_until(Pred pred)
+    {
+        for (int i = 0; i < spin_count + yield_count; i++) {
+            if (pred()) {
+                return;
+            }
+            if (i >= spin_count) {
+                std::this_thread::yield();
+            }
+        }
+
+        while (true) {
+            std::uint64_t gen = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                gen = generation_;
+            }
+
+            // Pairs with the fence in notify_all(): either we see the new
+            // state, or the notifier sees us waiting and bumps generation_
+            waiters_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (pred()) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return generation_ != gen; });
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void notify_all()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++generation_;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    static constexpr int spin_count = 64;
+    static constexpr int yield_count = 64;
+
+    std::atomic<int> waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::uint64_t generation_ = 0;
+};
+
+}
+
+#endif
@@ -112,6 +112,40 @@ inline constexpr bool has_next_back<T, std::enable_if_t<
 template <typename F>
 inline constexpr bool is_reversible_flow = is_flow<F> && detail::has_next_back<F>;
 
+namespace detail {
+
+template <typename, typename = void>
+inline constexpr bool is_random_access = false;
+
+template <typename T>
+inline constexpr bool is_random_access<T, std::enable_if_t<T::is_random_access>> = true;
+
+}
+
+// A random-access flow is a sized, multipass flow whose advance() is O(1).
+// Flows opt in to this by declaring a static constexpr bool is_random_access
+// member, in the same way as for is_infinite.
+template <typename F>
+inline constexpr bool is_random_access_flow =
+    is_multipass_flow<F> && is_sized_flow<F> && detail::is_random_access<F>;
+
+namespace detail {
+
+template <typename, typename = void>
+inline constexpr bool has_data = false;
+
+template <typename T>
+inline constexpr bool has_data<T, std::enable_if_t<
+    std::is_pointer_v<decltype(std::declval<T&>().data())>>> = true;
+
+}
+
+// A contiguous flow is a random-access flow whose remaining items are stored
+// in an array, a pointer to the start of which is returned by data().
+template <typename F>
+inline constexpr bool is_contiguous_flow =
+    is_random_access_flow<F> && detail::has_data<F>;
+
 } // namespace flow
 
 #endif
@@ -38,6 +38,33 @@ constexpr auto flow_base<D>::all(Pred pred) -> bool
     static_assert(std::is_invocable_r_v<bool, Pred&, item_t<D>>,
                   "Predicate must be callable with the Flow's item_type,"
                    " and must return bool");
+
+    if constexpr (detail::can_batch_predicate<D, Pred>) {
+        // Test a batch at a time, only looking for the exact position of
+        // the failing item once we know which batch it is in
+        const auto* data = derived().data();
+        const dist_t n = derived().size();
+        for (dist_t base = 0; base < n; base += detail::predicate_batch_size) {
+            const dist_t len = detail::min(detail::predicate_batch_size, n - base);
+            dist_t passed = 0;
+            for (dist_t i = 0; i < len; i++) {
+                passed += static_cast<dist_t>(invoke(pred, data[base + i]));
+            }
+            if (passed != len) {
+                dist_t i = base;
+                while (invoke(pred, data[i])) {
+                    ++i;
+                }
+                (void) derived().advance(i + 1);
+                return false;
+            }
+        }
+        if (n > 0) {
+            (void) derived().advance(n);
+        }
+        return true;
+    }
+
     return derived().try_fold([&pred](bool /*unused*/, auto&& m) {
       return invoke(pred, *FLOW_FWD(m));
     }, true);
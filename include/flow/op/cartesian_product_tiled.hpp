@@ -0,0 +1,194 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_CARTESIAN_PRODUCT_TILED_HPP_INCLUDED
+#define FLOW_OP_CARTESIAN_PRODUCT_TILED_HPP_INCLUDED
+
+#include <flow/op/zip.hpp>
+
+namespace flow {
+
+namespace detail {
+
+// Visits the product of two random-access flows one tile x tile block at a
+// time. The position of the next item is (i_, j_) within the block whose
+// top-left corner is (i0_, j0_); the underlying flows are never advanced.
+template <typename Func, typename Flow1, typename Flow2>
+struct cartesian_product_tiled_adaptor
+    : flow_base<cartesian_product_tiled_adaptor<Func, Flow1, Flow2>>
+{
+private:
+    FLOW_NO_UNIQUE_ADDRESS Func func_;
+    Flow1 f1_;
+    Flow2 f2_;
+    dist_t tile_;
+    dist_t n1_ = f1_.size();
+    dist_t n2_ = f2_.size();
+    dist_t i0_ = 0;
+    dist_t j0_ = 0;
+    dist_t i_ = 0;
+    dist_t j_ = 0;
+
+    using item_type = std::invoke_result_t<Func&, item_t<Flow1>&, item_t<Flow2>>;
+
+    // Moves (i_, j_) past the end of any finished row, block or band.
+    // Returns false once every item has been visited.
+    constexpr auto normalise_() -> bool
+    {
+        while (i0_ < n1_ && n2_ > 0) {
+            if (j0_ >= n2_) {
+                i0_ += tile_;
+                i_ = i0_;
+                j0_ = j_ = 0;
+            } else if (i_ >= detail::min(i0_ + tile_, n1_)) {
+                j0_ += tile_;
+                i_ = i0_;
+                j_ = j0_;
+            } else if (j_ >= detail::min(j0_ + tile_, n2_)) {
+                ++i_;
+                j_ = j0_;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    constexpr cartesian_product_tiled_adaptor(Func func, Flow1&& flow1, Flow2&& flow2,
+                                              dist_t tile)
+        : func_(std::move(func)),
+          f1_(std::move(flow1)),
+          f2_(std::move(flow2)),
+          tile_(tile)
+    {}
+
+    template <typename Fn, typename Init>
+    constexpr auto try_fold(Fn fn, Init init) -> Init
+    {
+        if (n2_ == 0) {
+            i0_ = i_ = n1_;
+            return init;
+        }
+
+        for (; i0_ < n1_; i0_ += tile_, i_ = i0_, j0_ = j_ = 0) {
+            const dist_t i_end = detail::min(i0_ + tile_, n1_);
+
+            for (; j0_ < n2_; j0_ += tile_, i_ = i0_, j_ = j0_) {
+                const dist_t j_end = detail::min(j0_ + tile_, n2_);
+
+                for (; i_ < i_end; ++i_, j_ = j0_) {
+                    auto m1 = f1_.subflow().advance(i_ + 1);
+                    auto s2 = f2_.subflow();
+                    if (j_ > 0) {
+                        (void) s2.advance(j_);
+                    }
+
+                    while (j_ < j_end) {
+                        auto m2 = s2.next();
+                        ++j_;
+                        init = invoke(fn, std::move(init),
+                                      maybe<item_type>(invoke(func_, *m1, *std::move(m2))));
+                        if (!static_cast<bool>(init)) {
+                            return init;
+                        }
+                    }
+                }
+            }
+        }
+
+        return init;
+    }
+
+    constexpr auto next() -> maybe<item_type>
+    {
+        if (!normalise_()) {
+            return {};
+        }
+        auto m1 = f1_.subflow().advance(i_ + 1);
+        auto m2 = f2_.subflow().advance(j_ + 1);
+        ++j_;
+        return {invoke(func_, *m1, *std::move(m2))};
+    }
+
+    [[nodiscard]] constexpr auto size() const -> dist_t
+    {
+        if (i0_ >= n1_) {
+            return 0;
+        }
+        // Items visited in earlier row-bands, then in earlier blocks of this
+        // band, then in earlier rows of this block
+        const dist_t rows = detail::min(tile_, n1_ - i0_);
+        const dist_t cols = detail::min(tile_, n2_ - j0_);
+        const dist_t done = i0_ * n2_ + rows * j0_ + (i_ - i0_) * cols + (j_ - j0_);
+        return n1_ * n2_ - done;
+    }
+};
+
+struct cartesian_product_tiled_fn {
+    template <typename Flowable1, typename Flowable2>
+    constexpr auto operator()(Flowable1&& flowable1, Flowable2&& flowable2,
+                              dist_t tile = 64) const
+    {
+        static_assert(is_flowable<Flowable1>,
+                      "Arguments to cartesian_product_tiled() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable1)))
+            .cartesian_product_tiled(FLOW_FWD(flowable2), tile);
+    }
+};
+
+struct cartesian_product_tiled_with_fn {
+    template <typename Func, typename Flowable1, typename Flowable2>
+    constexpr auto operator()(Func func, Flowable1&& flowable1, Flowable2&& flowable2,
+                              dist_t tile = 64) const
+    {
+        static_assert(is_flowable<Flowable1>,
+                      "Arguments to cartesian_product_tiled_with() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable1)))
+            .cartesian_product_tiled_with(std::move(func), FLOW_FWD(flowable2), tile);
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto cartesian_product_tiled = detail::cartesian_product_tiled_fn{};
+
+inline constexpr auto cartesian_product_tiled_with = detail::cartesian_product_tiled_with_fn{};
+
+template <typename D>
+template <typename Func, typename Flowable>
+constexpr auto flow_base<D>::cartesian_product_tiled_with(Func func, Flowable&& flowable,
+                                                          dist_t tile) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "Argument to cartesian_product_tiled_with() must be Flowable");
+    static_assert(is_random_access_flow<D> && is_random_access_flow<flow_t<Flowable>>,
+                  "Both flows passed to cartesian_product_tiled_with() must be "
+                  "random-access");
+    static_assert(std::is_invocable_v<Func&, item_t<D>&, flow_item_t<Flowable>>,
+                  "Incompatible callable passed to cartesian_product_tiled_with()");
+    assert(tile > 0);
+
+    return detail::cartesian_product_tiled_adaptor<Func, D, flow_t<Flowable>>(
+        std::move(func), consume(), flow::from(FLOW_FWD(flowable)), tile);
+}
+
+template <typename D>
+template <typename Flowable>
+constexpr auto flow_base<D>::cartesian_product_tiled(Flowable&& flowable, dist_t tile) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "Argument to cartesian_product_tiled() must be Flowable");
+
+    return consume().cartesian_product_tiled_with(
+        [](auto&& a, auto&& b) {
+            return detail::zip_item_t<D, flow_t<Flowable>>(FLOW_FWD(a), FLOW_FWD(b));
+        },
+        FLOW_FWD(flowable), tile);
+}
+
+}
+
+#endif
@@ -26,10 +26,10 @@ struct collector {
         if constexpr (std::is_constructible_v<C, Flow&&>) {
             return C(std::move(flow_));
         } else {
-            using iter_t = decltype(std::move(flow_).to_range().begin());
+            using iter_t = decltype(make_single_pass_range(std::move(flow_)).begin());
             static_assert(std::is_constructible_v<C, iter_t, iter_t>,
                           "Incompatible type on LHS of collect()");
-            auto rng = std::move(flow_).to_range();
+            auto rng = make_single_pass_range(std::move(flow_));
             return C(rng.begin(), rng.end());
         }
     }
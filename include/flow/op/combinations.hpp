@@ -0,0 +1,346 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_COMBINATIONS_HPP_INCLUDED
+#define FLOW_OP_COMBINATIONS_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+#include <array>
+#include <tuple>
+
+namespace flow {
+
+namespace detail {
+
+// The number of ways of choosing k items from n, ignoring order
+constexpr auto binomial(dist_t n, dist_t k) -> dist_t
+{
+    if (k < 0 || k > n) {
+        return 0;
+    }
+    k = detail::min(k, n - k);
+    dist_t res = 1;
+    for (dist_t i = 1; i <= k; ++i) {
+        res = res * (n - k + i) / i;
+    }
+    return res;
+}
+
+// The number of ways of choosing k items from n, in order
+constexpr auto falling_factorial(dist_t n, dist_t k) -> dist_t
+{
+    if (k < 0 || k > n) {
+        return 0;
+    }
+    dist_t res = 1;
+    for (dist_t i = 0; i < k; ++i) {
+        res *= n - i;
+    }
+    return res;
+}
+
+template <typename T, std::size_t K, typename = std::make_index_sequence<K>>
+struct repeat_tuple;
+
+template <typename T, std::size_t K, std::size_t... I>
+struct repeat_tuple<T, K, std::index_sequence<I...>> {
+    template <std::size_t>
+    using elem = T;
+
+    using type = std::tuple<elem<I>...>;
+};
+
+template <typename T>
+struct repeat_tuple<T, 2, std::index_sequence<0, 1>> {
+    using type = std::pair<T, T>;
+};
+
+template <typename T, std::size_t K>
+using repeat_tuple_t = typename repeat_tuple<T, K>::type;
+
+// Yields each selection of K distinct positions of a multipass, sized flow,
+// as a pair or tuple of the items at those positions. Selections are ordered
+// lexicographically by position; if Ordered is false, the positions within
+// each selection are increasing (combinations), otherwise any arrangement
+// of them is allowed (k-permutations).
+//
+// Rather than generating all tuples and filtering them, the positions are
+// stepped directly. Each position p has its own subflow subs_[p], which
+// has just yielded the item at idx_[p], currently held in heads_[p].
+// Selections are numbered from zero, so the position can be recomputed from
+// a number alone, which allows O(1) size() and fast advance().
+template <typename Flow, std::size_t K, bool Ordered>
+struct combinations_adaptor : flow_base<combinations_adaptor<Flow, K, Ordered>> {
+
+    static constexpr bool is_random_access = is_random_access_flow<Flow>;
+
+private:
+    using item_type = repeat_tuple_t<item_t<Flow>, K>;
+
+    template <typename, std::size_t, bool>
+    friend struct combinations_adaptor;
+
+    Flow flow_;
+    dist_t n_ = flow_.size();
+    dist_t total_ = Ordered ? falling_factorial(n_, K) : binomial(n_, K);
+    dist_t rank_ = 0;
+    bool positioned_ = false;
+    std::array<dist_t, K> idx_{};
+    std::array<subflow_t<Flow>, K> subs_ = make_subs_(std::make_index_sequence<K>{});
+    std::array<next_t<subflow_t<Flow>>, K> heads_{};
+
+    template <std::size_t... I>
+    constexpr auto make_subs_(std::index_sequence<I...>)
+    {
+        return std::array<subflow_t<Flow>, K>{((void) I, flow_.subflow())...};
+    }
+
+    constexpr auto used_(dist_t v, std::size_t p) const -> bool
+    {
+        for (std::size_t q = 0; q < p; ++q) {
+            if (idx_[q] == v) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The lowest position allowed at p, given the positions before it
+    constexpr auto first_candidate_(std::size_t p) const -> dist_t
+    {
+        if constexpr (Ordered) {
+            dist_t v = 0;
+            while (used_(v, p)) {
+                ++v;
+            }
+            return v;
+        } else {
+            return p == 0 ? 0 : idx_[p - 1] + 1;
+        }
+    }
+
+    // The position following idx_[p] at p, or n_ if there is none
+    constexpr auto next_candidate_(std::size_t p) const -> dist_t
+    {
+        dist_t v = idx_[p] + 1;
+        if constexpr (Ordered) {
+            while (v < n_ && used_(v, p)) {
+                ++v;
+            }
+            return v;
+        } else {
+            // Leave room for the positions after p
+            return v <= n_ - dist_t(K - p) ? v : n_;
+        }
+    }
+
+    constexpr void restart_(std::size_t p, dist_t v)
+    {
+        if (!Ordered && p > 0) {
+            subs_[p] = subs_[p - 1];
+            heads_[p] = subs_[p].advance(v - idx_[p - 1]);
+        } else {
+            subs_[p] = flow_.subflow();
+            heads_[p] = subs_[p].advance(v + 1);
+        }
+        idx_[p] = v;
+    }
+
+    // Moves on to the next selection, which must exist
+    constexpr void increment_()
+    {
+        std::size_t p = K;
+        while (p-- > 0) {
+            dist_t v = next_candidate_(p);
+            if (v < n_) {
+                heads_[p] = subs_[p].advance(v - idx_[p]);
+                idx_[p] = v;
+                break;
+            }
+        }
+        for (++p; p < K; ++p) {
+            restart_(p, first_candidate_(p));
+        }
+    }
+
+    // Positions the subflows at selection number r
+    constexpr void seek_(dist_t r)
+    {
+        for (std::size_t p = 0; p < K; ++p) {
+            const auto rest = dist_t(K - p - 1);
+            dist_t v = 0;
+            if constexpr (Ordered) {
+                // Each choice at p is followed by a block of equal size
+                const dist_t block = falling_factorial(n_ - dist_t(p) - 1, rest);
+                v = r / block;
+                r %= block;
+                // Find the v-th position not already used
+                std::array<dist_t, K> prev = idx_;
+                for (std::size_t i = 1; i < p; ++i) {
+                    for (std::size_t j = i; j > 0 && prev[j - 1] > prev[j]; --j) {
+                        const dist_t tmp = prev[j];
+                        prev[j] = prev[j - 1];
+                        prev[j - 1] = tmp;
+                    }
+                }
+                for (std::size_t i = 0; i < p; ++i) {
+                    v += prev[i] <= v;
+                }
+            } else {
+                // Choosing v at p skips all selections starting with a lower
+                // position, of which there are C(n - lo, rest + 1) - C(n - v, rest + 1)
+                const dist_t lo = p == 0 ? 0 : idx_[p - 1] + 1;
+                const dist_t all = binomial(n_ - lo, rest + 1);
+                dist_t hi = n_ - rest - 1;
+                v = lo;
+                while (v < hi) {
+                    const dist_t mid = v + (hi - v + 1) / 2;
+                    if (all - binomial(n_ - mid, rest + 1) <= r) {
+                        v = mid;
+                    } else {
+                        hi = mid - 1;
+                    }
+                }
+                r -= all - binomial(n_ - v, rest + 1);
+            }
+            restart_(p, v);
+        }
+        positioned_ = true;
+    }
+
+    template <std::size_t... I>
+    constexpr auto make_item_(std::index_sequence<I...>) -> item_type
+    {
+        return item_type(*heads_[I]..., *std::move(heads_[K - 1]));
+    }
+
+    // Produces the current selection and moves on to the next
+    constexpr auto take_() -> item_type
+    {
+        item_type item = make_item_(std::make_index_sequence<K - 1>{});
+        if (++rank_ < total_) {
+            increment_();
+        }
+        return item;
+    }
+
+public:
+    constexpr explicit combinations_adaptor(Flow&& flow, dist_t rank = 0)
+        : flow_(std::move(flow)),
+          rank_(rank)
+    {}
+
+    constexpr auto next() -> maybe<item_type>
+    {
+        if (rank_ >= total_) {
+            return {};
+        }
+        if (!positioned_) {
+            seek_(rank_);
+        }
+        return {take_()};
+    }
+
+    constexpr auto advance(dist_t dist) -> maybe<item_type>
+    {
+        assert(dist > 0);
+        if (dist == 1) {
+            return next();
+        }
+        if (dist > total_ - rank_) {
+            rank_ = total_;
+            return {};
+        }
+        rank_ += dist - 1;
+        seek_(rank_);
+        return {take_()};
+    }
+
+    template <typename Fn, typename Init>
+    constexpr auto try_fold(Fn fn, Init init) -> Init
+    {
+        if (rank_ < total_ && !positioned_) {
+            seek_(rank_);
+        }
+        while (rank_ < total_) {
+            init = invoke(fn, std::move(init), maybe<item_type>(take_()));
+            if (!static_cast<bool>(init)) {
+                break;
+            }
+        }
+        return init;
+    }
+
+    template <typename F = Flow>
+    constexpr auto subflow() & -> combinations_adaptor<subflow_t<F>, K, Ordered>
+    {
+        return combinations_adaptor<subflow_t<F>, K, Ordered>(flow_.subflow(), rank_);
+    }
+
+    [[nodiscard]] constexpr auto size() const -> dist_t
+    {
+        return total_ - rank_;
+    }
+};
+
+template <std::size_t K, bool Ordered, typename Flow>
+constexpr auto make_combinations(Flow&& flow)
+{
+    static_assert(K > 0, "The number of items in each selection must be at least one");
+    static_assert(is_multipass_flow<Flow> && is_sized_flow<Flow>,
+                  "combinations(), pairs() and permutations() require a "
+                  "multipass, sized flow");
+    return combinations_adaptor<Flow, K, Ordered>(std::move(flow));
+}
+
+} // namespace detail
+
+template <std::size_t K, typename Flowable>
+constexpr auto combinations(Flowable&& flowable)
+{
+    static_assert(is_flowable<Flowable>,
+                  "Argument to flow::combinations() must be Flowable");
+    return FLOW_COPY(flow::from(FLOW_FWD(flowable))).template combinations<K>();
+}
+
+template <std::size_t K, typename Flowable>
+constexpr auto permutations(Flowable&& flowable)
+{
+    static_assert(is_flowable<Flowable>,
+                  "Argument to flow::permutations() must be Flowable");
+    return FLOW_COPY(flow::from(FLOW_FWD(flowable))).template permutations<K>();
+}
+
+inline constexpr auto pairs = [](auto&& flowable)
+{
+    static_assert(is_flowable<decltype(flowable)>,
+                  "Argument to flow::pairs() must be Flowable");
+    return FLOW_COPY(flow::from(FLOW_FWD(flowable))).pairs();
+};
+
+template <typename D>
+template <std::size_t K>
+constexpr auto flow_base<D>::combinations() &&
+{
+    return detail::make_combinations<K, false>(consume());
+}
+
+template <typename D>
+constexpr auto flow_base<D>::pairs() &&
+{
+    return consume().template combinations<2>();
+}
+
+template <typename D>
+template <std::size_t K>
+constexpr auto flow_base<D>::permutations() &&
+{
+    return detail::make_combinations<K, true>(consume());
+}
+
+}
+
+#endif
@@ -24,9 +24,23 @@ constexpr auto flow_base<Derived>::count_if(Pred pred) -> dist_t
     static_assert(std::is_invocable_r_v<bool, Pred&, item_t<Derived>>,
                   "Predicate must be callable with the Flow's item_type,"
                   " and must return bool");
-    return consume().fold([&pred](dist_t count, auto&& val) {
-      return count + static_cast<dist_t>(invoke(pred, FLOW_FWD(val)));
-    }, dist_t{0});
+
+    if constexpr (detail::can_batch_predicate<Derived, Pred>) {
+        const auto* data = derived().data();
+        const dist_t n = derived().size();
+        dist_t count = 0;
+        for (dist_t i = 0; i < n; i++) {
+            count += static_cast<dist_t>(invoke(pred, data[i]));
+        }
+        if (n > 0) {
+            (void) derived().advance(n);
+        }
+        return count;
+    } else {
+        return consume().fold([&pred](dist_t count, auto&& val) {
+            return count + static_cast<dist_t>(invoke(pred, FLOW_FWD(val)));
+        }, dist_t{0});
+    }
 }
 
 } // namespace flow
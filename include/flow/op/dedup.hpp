@@ -0,0 +1,107 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_DEDUP_HPP_INCLUDED
+#define FLOW_OP_DEDUP_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+namespace flow {
+
+namespace detail {
+
+template <typename Flow, typename Key>
+struct dedup_adaptor : flow_base<dedup_adaptor<Flow, Key>> {
+private:
+    template <typename, typename>
+    friend struct dedup_adaptor;
+
+    using key_type = remove_cvref_t<std::invoke_result_t<Key&, value_t<Flow> const&>>;
+
+    // If the items are references into a multipass flow, they remain valid
+    // after we call next() again, so we can hang on to the previous item
+    // itself (which is just a pointer) rather than taking a copy of its key
+    static constexpr bool store_item =
+        std::is_lvalue_reference_v<item_t<Flow>> && is_multipass_flow<Flow>;
+
+    using last_type = std::conditional_t<store_item, next_t<Flow>, maybe<key_type>>;
+
+    Flow flow_;
+    FLOW_NO_UNIQUE_ADDRESS Key key_;
+    last_type last_{};
+
+    constexpr auto is_dup(value_t<Flow> const& item) -> bool
+    {
+        if (!last_) {
+            return false;
+        }
+        if constexpr (store_item) {
+            return invoke(key_, std::as_const(*last_)) == invoke(key_, item);
+        } else {
+            return *last_ == invoke(key_, item);
+        }
+    }
+
+public:
+    constexpr dedup_adaptor(Flow&& flow, Key&& key)
+        : flow_(std::move(flow)),
+          key_(std::move(key))
+    {}
+
+    constexpr auto next() -> next_t<Flow>
+    {
+        while (auto m = flow_.next()) {
+            if (is_dup(std::as_const(*m))) {
+                continue;
+            }
+            if constexpr (store_item) {
+                last_ = m;
+            } else {
+                last_ = key_type(invoke(key_, std::as_const(*m)));
+            }
+            return m;
+        }
+        return {};
+    }
+
+    template <typename F = Flow>
+    constexpr auto subflow() & -> dedup_adaptor<subflow_t<F>, function_ref<Key>>
+    {
+        auto s = dedup_adaptor<subflow_t<F>, function_ref<Key>>(flow_.subflow(), key_);
+        s.last_ = last_;
+        return s;
+    }
+};
+
+struct dedup_fn {
+    template <typename Flowable, typename Key = identity>
+    constexpr auto operator()(Flowable&& flowable, Key key = Key{}) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::dedup() must be a Flowable type");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable))).dedup(std::move(key));
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto dedup = detail::dedup_fn{};
+
+template <typename D>
+template <typename Key>
+constexpr auto flow_base<D>::dedup(Key key) &&
+{
+    static_assert(std::is_invocable_v<Key&, value_t<D> const&>,
+                  "Incompatible key function passed to dedup()");
+    using key_type = remove_cvref_t<std::invoke_result_t<Key&, value_t<D> const&>>;
+    static_assert(std::is_invocable_r_v<bool, equal_to, key_type const&, key_type const&>,
+                  "The key type used with dedup() must be equality comparable");
+
+    return detail::dedup_adaptor<D, Key>(consume(), std::move(key));
+}
+
+}
+
+#endif
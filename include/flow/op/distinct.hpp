@@ -0,0 +1,156 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_DISTINCT_HPP_INCLUDED
+#define FLOW_OP_DISTINCT_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+#include <flow/core/hash_table.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+template <typename Flow, typename Key>
+using distinct_key_t = remove_cvref_t<std::invoke_result_t<Key&, value_t<Flow> const&>>;
+
+template <typename Flow, typename Key>
+struct distinct_adaptor : flow_base<distinct_adaptor<Flow, Key>> {
+
+    constexpr distinct_adaptor(Flow&& flow, Key&& key)
+        : flow_(std::move(flow)),
+          key_(std::move(key))
+    {}
+
+    auto next() -> next_t<Flow>
+    {
+        while (auto m = flow_.next()) {
+            if (seen_.insert(invoke(key_, std::as_const(*m)))) {
+                return m;
+            }
+        }
+        return {};
+    }
+
+private:
+    Flow flow_;
+    FLOW_NO_UNIQUE_ADDRESS Key key_;
+    hash_set<distinct_key_t<Flow, Key>> seen_;
+};
+
+// A fixed-size Bloom filter, using the "double hashing" scheme of Kirsch and
+// Mitzenmacher to derive each of the probe positions from a single hash value
+struct bloom_filter {
+    static constexpr int num_probes = 4;
+
+    explicit bloom_filter(std::size_t num_bytes)
+        : words_(detail::max(num_bytes / sizeof(std::uint64_t), std::size_t{1}))
+    {}
+
+    // Sets the bits for `hash`, returning true if they were not all set before
+    auto insert(std::uint64_t hash) -> bool
+    {
+        const std::uint64_t num_bits = words_.size() * 64;
+        const std::uint64_t h1 = hash_mix(hash);
+        const std::uint64_t h2 = hash_mix(h1) | 1;
+
+        bool inserted = false;
+        for (int i = 0; i < num_probes; i++) {
+            const std::uint64_t bit = (h1 + static_cast<std::uint64_t>(i) * h2) % num_bits;
+            auto& word = words_[bit / 64];
+            const std::uint64_t mask = std::uint64_t{1} << (bit % 64);
+            inserted |= !(word & mask);
+            word |= mask;
+        }
+        return inserted;
+    }
+
+private:
+    std::vector<std::uint64_t> words_;
+};
+
+template <typename Flow, typename Key>
+struct distinct_approx_adaptor : flow_base<distinct_approx_adaptor<Flow, Key>> {
+
+    distinct_approx_adaptor(Flow&& flow, std::size_t num_bytes, Key&& key)
+        : flow_(std::move(flow)),
+          key_(std::move(key)),
+          filter_(num_bytes)
+    {}
+
+    auto next() -> next_t<Flow>
+    {
+        while (auto m = flow_.next()) {
+            if (filter_.insert(hash_(invoke(key_, std::as_const(*m))))) {
+                return m;
+            }
+        }
+        return {};
+    }
+
+private:
+    Flow flow_;
+    FLOW_NO_UNIQUE_ADDRESS Key key_;
+    FLOW_NO_UNIQUE_ADDRESS std::hash<distinct_key_t<Flow, Key>> hash_{};
+    bloom_filter filter_;
+};
+
+struct distinct_fn {
+    template <typename Flowable, typename Key = identity>
+    auto operator()(Flowable&& flowable, Key key = Key{}) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::distinct() must be a Flowable type");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable))).distinct(std::move(key));
+    }
+};
+
+struct distinct_approx_fn {
+    template <typename Flowable, typename Key = identity>
+    auto operator()(Flowable&& flowable, std::size_t num_bytes, Key key = Key{}) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::distinct_approx() must be a Flowable type");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable)))
+            .distinct_approx(num_bytes, std::move(key));
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto distinct = detail::distinct_fn{};
+
+inline constexpr auto distinct_approx = detail::distinct_approx_fn{};
+
+template <typename D>
+template <typename Key>
+auto flow_base<D>::distinct(Key key) &&
+{
+    static_assert(std::is_invocable_v<Key&, value_t<D> const&>,
+                  "Incompatible key function passed to distinct()");
+    using key_type = detail::distinct_key_t<D, Key>;
+    static_assert(std::is_invocable_r_v<bool, equal_to, key_type const&, key_type const&>,
+                  "The key type used with distinct() must be equality comparable");
+
+    return detail::distinct_adaptor<D, Key>(consume(), std::move(key));
+}
+
+template <typename D>
+template <typename Key>
+auto flow_base<D>::distinct_approx(std::size_t num_bytes, Key key) &&
+{
+    static_assert(std::is_invocable_v<Key&, value_t<D> const&>,
+                  "Incompatible key function passed to distinct_approx()");
+    assert(num_bytes > 0 && "distinct_approx() requires a non-zero memory budget");
+
+    return detail::distinct_approx_adaptor<D, Key>(consume(), num_bytes, std::move(key));
+}
+
+}
+
+#endif
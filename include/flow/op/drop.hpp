@@ -16,6 +16,7 @@ template <typename Flow>
 struct drop_adaptor : flow_base<drop_adaptor<Flow>>
 {
     static constexpr bool is_infinite = is_infinite_flow<Flow>;
+    static constexpr bool is_random_access = is_random_access_flow<Flow>;
 
     constexpr drop_adaptor(Flow&& flow, dist_t count)
         : flow_(std::move(flow)),
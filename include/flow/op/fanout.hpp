@@ -0,0 +1,421 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_FANOUT_HPP_INCLUDED
+#define FLOW_OP_FANOUT_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+#include <flow/op/minmax.hpp>
+
+#include <tuple>
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+// A sink receives items pushed to it one at a time as lvalues, through
+// accept(item), and produces its result from result() &&.
+//
+// Some sinks (for example min()) cannot know their result type until they
+// know the item type. These are created as specifications, which are turned
+// into a concrete sink by bind<Item>() once the item type is known. Sinks
+// whose type is already complete simply return themselves from bind().
+template <typename Derived>
+struct sink_base {
+    template <typename Item>
+    constexpr auto bind() && -> Derived
+    {
+        return std::move(static_cast<Derived&>(*this));
+    }
+};
+
+template <typename Item>
+using sink_value_t = remove_cvref_t<Item>;
+
+template <typename Func, typename Init>
+struct fold_sink : sink_base<fold_sink<Func, Init>> {
+
+    constexpr fold_sink(Func func, Init init)
+        : func_(std::move(func)), acc_(std::move(init))
+    {}
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        acc_ = invoke(func_, std::move(acc_), item);
+    }
+
+    constexpr auto result() && -> Init { return std::move(acc_); }
+
+private:
+    FLOW_NO_UNIQUE_ADDRESS Func func_;
+    Init acc_;
+};
+
+template <typename Pred>
+struct count_if_sink : sink_base<count_if_sink<Pred>> {
+
+    constexpr explicit count_if_sink(Pred pred) : pred_(std::move(pred)) {}
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        count_ += static_cast<bool>(invoke(pred_, std::as_const(item)));
+    }
+
+    constexpr auto result() && -> dist_t { return count_; }
+
+private:
+    FLOW_NO_UNIQUE_ADDRESS Pred pred_;
+    dist_t count_ = 0;
+};
+
+template <typename Func>
+struct for_each_sink : sink_base<for_each_sink<Func>> {
+
+    constexpr explicit for_each_sink(Func func) : func_(std::move(func)) {}
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        (void) invoke(func_, item);
+    }
+
+    constexpr auto result() && -> Func { return std::move(func_); }
+
+private:
+    Func func_;
+};
+
+template <typename Iter>
+struct output_to_sink : sink_base<output_to_sink<Iter>> {
+
+    constexpr explicit output_to_sink(Iter iter) : iter_(std::move(iter)) {}
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        *iter_ = item;
+        ++iter_;
+    }
+
+    constexpr auto result() && -> Iter { return std::move(iter_); }
+
+private:
+    Iter iter_;
+};
+
+template <typename V>
+struct to_vector_sink {
+    template <typename Item>
+    auto bind() && { return std::move(*this); }
+
+    template <typename T>
+    void accept(T& item) { vec_.push_back(item); }
+
+    auto result() && -> std::vector<V> { return std::move(vec_); }
+
+private:
+    std::vector<V> vec_;
+};
+
+struct to_vector_sink_spec {
+    template <typename Item>
+    auto bind() && { return to_vector_sink<sink_value_t<Item>>{}; }
+};
+
+struct sum_sink_spec {
+    template <typename Item>
+    constexpr auto bind() &&
+    {
+        using V = sink_value_t<Item>;
+        return fold_sink<std::plus<>, V>(std::plus<>{}, V{});
+    }
+};
+
+// Like flow_base::min() and max(), ties go to the first minimal item and
+// the last maximal item
+template <typename V, typename Cmp, bool IsMax>
+struct extremum_sink : sink_base<extremum_sink<V, Cmp, IsMax>> {
+
+    constexpr explicit extremum_sink(Cmp cmp) : cmp_(std::move(cmp)) {}
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        if (!best_) {
+            best_ = maybe<V>(item);
+        } else if constexpr (IsMax) {
+            if (!invoke(cmp_, item, *best_)) {
+                *best_ = item;
+            }
+        } else {
+            if (invoke(cmp_, item, *best_)) {
+                *best_ = item;
+            }
+        }
+    }
+
+    constexpr auto result() && -> maybe<V> { return std::move(best_); }
+
+private:
+    FLOW_NO_UNIQUE_ADDRESS Cmp cmp_;
+    maybe<V> best_;
+};
+
+template <typename Cmp, bool IsMax>
+struct extremum_sink_spec {
+    Cmp cmp;
+
+    template <typename Item>
+    constexpr auto bind() &&
+    {
+        return extremum_sink<sink_value_t<Item>, Cmp, IsMax>(std::move(cmp));
+    }
+};
+
+template <typename V, typename Cmp>
+struct minmax_sink : sink_base<minmax_sink<V, Cmp>> {
+
+    constexpr explicit minmax_sink(Cmp cmp) : cmp_(std::move(cmp)) {}
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        if (!mm_) {
+            mm_ = maybe<minmax_result<V>>(minmax_result<V>{item, item});
+            return;
+        }
+        if (invoke(cmp_, item, mm_->min)) {
+            mm_->min = item;
+        }
+        if (!invoke(cmp_, item, mm_->max)) {
+            mm_->max = item;
+        }
+    }
+
+    constexpr auto result() && -> maybe<minmax_result<V>> { return std::move(mm_); }
+
+private:
+    FLOW_NO_UNIQUE_ADDRESS Cmp cmp_;
+    maybe<minmax_result<V>> mm_;
+};
+
+template <typename Cmp>
+struct minmax_sink_spec {
+    Cmp cmp;
+
+    template <typename Item>
+    constexpr auto bind() &&
+    {
+        return minmax_sink<sink_value_t<Item>, Cmp>(std::move(cmp));
+    }
+};
+
+template <typename Func, typename Sink>
+struct map_sink {
+
+    constexpr map_sink(Func func, Sink sink)
+        : func_(std::move(func)), sink_(std::move(sink))
+    {}
+
+    template <typename Item>
+    constexpr auto bind() &&
+    {
+        using mapped_t = std::invoke_result_t<Func&, Item&>;
+        using bound_t = decltype(std::declval<Sink>().template bind<mapped_t>());
+        return map_sink<Func, bound_t>(std::move(func_),
+                                       std::move(sink_).template bind<mapped_t>());
+    }
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        auto&& mapped = invoke(func_, item);
+        sink_.accept(mapped);
+    }
+
+    constexpr auto result() && { return std::move(sink_).result(); }
+
+private:
+    FLOW_NO_UNIQUE_ADDRESS Func func_;
+    Sink sink_;
+};
+
+template <typename Pred, typename Sink>
+struct filter_sink {
+
+    constexpr filter_sink(Pred pred, Sink sink)
+        : pred_(std::move(pred)), sink_(std::move(sink))
+    {}
+
+    template <typename Item>
+    constexpr auto bind() &&
+    {
+        using bound_t = decltype(std::declval<Sink>().template bind<Item>());
+        return filter_sink<Pred, bound_t>(std::move(pred_),
+                                          std::move(sink_).template bind<Item>());
+    }
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        if (invoke(pred_, std::as_const(item))) {
+            sink_.accept(item);
+        }
+    }
+
+    constexpr auto result() && { return std::move(sink_).result(); }
+
+private:
+    FLOW_NO_UNIQUE_ADDRESS Pred pred_;
+    Sink sink_;
+};
+
+template <typename... Sinks>
+struct fanout_sink {
+
+    constexpr explicit fanout_sink(Sinks... sinks)
+        : sinks_(std::move(sinks)...)
+    {}
+
+    template <typename Item>
+    constexpr auto bind() &&
+    {
+        return std::apply([](auto&&... s) {
+            return fanout_sink<decltype(std::move(s).template bind<Item>())...>(
+                std::move(s).template bind<Item>()...);
+        }, std::move(sinks_));
+    }
+
+    template <typename T>
+    constexpr void accept(T& item)
+    {
+        std::apply([&item](auto&... s) { (s.accept(item), ...); }, sinks_);
+    }
+
+    constexpr auto result() &&
+    {
+        return std::apply([](auto&&... s) {
+            return std::tuple<decltype(std::move(s).result())...>(
+                std::move(s).result()...);
+        }, std::move(sinks_));
+    }
+
+private:
+    std::tuple<Sinks...> sinks_;
+};
+
+struct fanout_fn {
+    template <typename Flowable, typename... Sinks>
+    constexpr auto operator()(Flowable&& flowable, Sinks... sinks) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::fanout() must be a Flowable type");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable))).fanout(std::move(sinks)...);
+    }
+};
+
+} // namespace detail
+
+/// Composable sinks for use with `flow::fanout()`.
+///
+/// Each sink consumes items pushed to it and produces a result once the
+/// source is exhausted, with the same semantics as the flow terminal
+/// operation of the same name.
+namespace sink {
+
+template <typename Func, typename Init>
+constexpr auto fold(Func func, Init init)
+{
+    return detail::fold_sink<Func, Init>(std::move(func), std::move(init));
+}
+
+template <typename Pred>
+constexpr auto count_if(Pred pred)
+{
+    return detail::count_if_sink<Pred>(std::move(pred));
+}
+
+constexpr auto count()
+{
+    return count_if([](auto const&) { return true; });
+}
+
+constexpr auto sum() { return detail::sum_sink_spec{}; }
+
+template <typename Cmp = less>
+constexpr auto min(Cmp cmp = Cmp{})
+{
+    return detail::extremum_sink_spec<Cmp, false>{std::move(cmp)};
+}
+
+template <typename Cmp = less>
+constexpr auto max(Cmp cmp = Cmp{})
+{
+    return detail::extremum_sink_spec<Cmp, true>{std::move(cmp)};
+}
+
+template <typename Cmp = less>
+constexpr auto minmax(Cmp cmp = Cmp{})
+{
+    return detail::minmax_sink_spec<Cmp>{std::move(cmp)};
+}
+
+template <typename Func>
+constexpr auto for_each(Func func)
+{
+    return detail::for_each_sink<Func>(std::move(func));
+}
+
+template <typename Iter>
+constexpr auto output_to(Iter iter)
+{
+    return detail::output_to_sink<Iter>(std::move(iter));
+}
+
+inline auto to_vector() { return detail::to_vector_sink_spec{}; }
+
+template <typename T>
+auto to_vector() { return detail::to_vector_sink<T>{}; }
+
+/// Passes `func(item)` to `sink` for each item
+template <typename Func, typename Sink>
+constexpr auto map(Func func, Sink sink)
+{
+    return detail::map_sink<Func, Sink>(std::move(func), std::move(sink));
+}
+
+/// Passes to `sink` only those items for which `pred(item)` is true
+template <typename Pred, typename Sink>
+constexpr auto filter(Pred pred, Sink sink)
+{
+    return detail::filter_sink<Pred, Sink>(std::move(pred), std::move(sink));
+}
+
+/// Passes each item to all of `sinks`, producing a tuple of their results
+template <typename... Sinks>
+constexpr auto fanout(Sinks... sinks)
+{
+    return detail::fanout_sink<Sinks...>(std::move(sinks)...);
+}
+
+} // namespace sink
+
+inline constexpr auto fanout = detail::fanout_fn{};
+
+template <typename D>
+template <typename... Sinks>
+constexpr auto flow_base<D>::fanout(Sinks... sinks)
+{
+    auto root = sink::fanout(std::move(sinks)...).template bind<item_t<D>>();
+    derived().for_each([&root](auto&& item) { root.accept(item); });
+    return std::move(root).result();
+}
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #define FLOW_OP_FILTER_HPP_INCLUDED
 
 #include <flow/core/flow_base.hpp>
+#include <flow/op/map_filter.hpp>
 
 namespace flow {
 
@@ -36,6 +37,11 @@ struct filter_adaptor : flow_base<filter_adaptor<Flow, Pred>> {
         return {flow_.subflow(), pred_};
     }
 
+    constexpr auto fuse() && -> map_filter_adaptor<Flow, filter_stage<Pred>>
+    {
+        return {std::move(flow_), std::tuple<filter_stage<Pred>>{{std::move(pred_)}}};
+    }
+
 private:
     Flow flow_;
     Pred pred_;
@@ -57,7 +63,11 @@ constexpr auto flow_base<D>::filter(Pred pred) &&
     static_assert(std::is_invocable_r_v<bool, Pred&, value_t<D> const&>,
                   "Incompatible predicate passed to filter()");
 
-    return detail::filter_adaptor<D, Pred>(consume(), std::move(pred));
+    if constexpr (detail::is_fusable<D>) {
+        return consume().fuse().then(detail::filter_stage<Pred>{std::move(pred)});
+    } else {
+        return detail::filter_adaptor<D, Pred>(consume(), std::move(pred));
+    }
 }
 
 }
@@ -12,9 +12,19 @@ namespace flow {
 
 namespace detail {
 
+// Inner ranges which to_vector() can append in a single insert() call
+template <typename R, typename = void>
+inline constexpr bool is_bulk_appendable = false;
+
+template <typename R>
+inline constexpr bool is_bulk_appendable<R, std::enable_if_t<is_stl_range<R>>> =
+    is_fwd_stl_range<R> && std::is_same_v<iterator_t<R>, sentinel_t<R>>;
+
 template <typename Base>
 struct flatten_adaptor : flow_base<flatten_adaptor<Base>> {
 
+    using flow_base<flatten_adaptor>::to_vector;
+
     constexpr explicit flatten_adaptor(Base&& base)
         : base_(std::move(base))
     {}
@@ -37,6 +47,55 @@ struct flatten_adaptor : flow_base<flatten_adaptor<Base>> {
         }
     }
 
+    // Runs each inner flow's own try_fold() in turn, rather than checking
+    // for the end of the inner flow on every item
+    template <typename Func, typename Init>
+    constexpr auto try_fold(Func func, Init init) -> Init
+    {
+        auto inner_fn = [&func](Init acc, auto&& m) -> Init {
+            return invoke(func, std::move(acc), FLOW_FWD(m));
+        };
+
+        if (inner_) {
+            init = inner_->try_fold(inner_fn, std::move(init));
+            if (!static_cast<bool>(init)) {
+                return init;
+            }
+            inner_.reset();
+        }
+
+        return base_.try_fold([this, &inner_fn](Init acc, auto&& m) -> Init {
+            decltype(auto) inner = flow::from(*FLOW_FWD(m));
+            acc = inner.try_fold(inner_fn, std::move(acc));
+            if (!static_cast<bool>(acc)) {
+                // Keep the rest of this inner flow for next time
+                inner_ = maybe<flow_t<item_t<Base>>>(FLOW_FWD(inner));
+            }
+            return acc;
+        }, std::move(init));
+    }
+
+    // When the inner items are STL ranges, appends each of them in bulk
+    // rather than pushing back one item at a time
+    auto to_vector() &&
+    {
+        using vector_t = std::vector<value_t<flatten_adaptor>>;
+
+        if constexpr (is_bulk_appendable<std::remove_reference_t<item_t<Base>>>) {
+            vector_t vec;
+            if (inner_) {
+                inner_->for_each([&vec](auto&& item) { vec.push_back(FLOW_FWD(item)); });
+                inner_.reset();
+            }
+            base_.for_each([&vec](auto&& rng) {
+                vec.insert(vec.end(), detail::begin(rng), detail::end(rng));
+            });
+            return vec;
+        } else {
+            return std::move(*this).template to<vector_t>();
+        }
+    }
+
     template <typename F = Base,
               typename = std::enable_if_t<is_multipass_flow<flow_t<item_t<F>>>>>
     constexpr auto subflow() -> flatten_adaptor<subflow_t<F>>
@@ -0,0 +1,388 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_JOIN_HPP_INCLUDED
+#define FLOW_OP_JOIN_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+#include <flow/core/hash_table.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+template <typename Flow, typename Key>
+using join_key_t = remove_cvref_t<std::invoke_result_t<Key&, value_t<Flow> const&>>;
+
+// An item of the streamed side may be paired with several others, so we
+// cannot move from it. Rvalue items become values.
+template <typename Flow>
+using join_item_t = std::conditional_t<std::is_lvalue_reference_v<item_t<Flow>>,
+                                       item_t<Flow>, value_t<Flow>>;
+
+// Passes through a key of the table's key type, avoiding a copy, or
+// otherwise converts to it
+template <typename K, typename T>
+constexpr auto as_key(T&& t) -> std::conditional_t<std::is_same_v<remove_cvref_t<T>, K>, T&&, K>
+{
+    return FLOW_FWD(t);
+}
+
+// Streams the items of the probe flow, pairing each with all the items of
+// the build flow with matching keys. The build flow is only read (in its
+// entirety) the first time next() is called.
+template <typename Probe, typename Build, typename ProbeKey, typename BuildKey>
+struct hash_join_adaptor : flow_base<hash_join_adaptor<Probe, Build, ProbeKey, BuildKey>> {
+private:
+    using key_type = join_key_t<Build, BuildKey>;
+    using row_type = value_t<Build>;
+    using item_type = std::pair<join_item_t<Probe>, row_type const&>;
+
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    // Rows with equal keys form a singly-linked list, threaded through
+    // chain_, in the order in which they were read
+    struct bucket {
+        std::size_t first = npos;
+        std::size_t last = npos;
+    };
+
+    Probe probe_;
+    Build build_;
+    FLOW_NO_UNIQUE_ADDRESS ProbeKey probe_key_;
+    FLOW_NO_UNIQUE_ADDRESS BuildKey build_key_;
+
+    std::vector<row_type> rows_;
+    std::vector<std::size_t> chain_;
+    hash_table<key_type, bucket> table_;
+    bool built_ = false;
+
+    next_t<Probe> current_{};
+    std::size_t match_ = npos;
+
+    void build()
+    {
+        if constexpr (is_sized_flow<Build>) {
+            const auto n = static_cast<std::size_t>(build_.size());
+            rows_.reserve(n);
+            chain_.reserve(n);
+            table_.reserve(n);
+        }
+
+        while (auto m = build_.next()) {
+            const std::size_t idx = rows_.size();
+            auto [b, inserted] = table_.try_emplace(invoke(build_key_, std::as_const(*m)));
+            if (inserted) {
+                b->first = idx;
+            } else {
+                chain_[b->last] = idx;
+            }
+            b->last = idx;
+            rows_.push_back(*std::move(m));
+            chain_.push_back(npos);
+        }
+
+        built_ = true;
+    }
+
+public:
+    hash_join_adaptor(Probe&& probe, Build&& build, ProbeKey&& probe_key, BuildKey&& build_key)
+        : probe_(std::move(probe)),
+          build_(std::move(build)),
+          probe_key_(std::move(probe_key)),
+          build_key_(std::move(build_key))
+    {}
+
+    auto next() -> maybe<item_type>
+    {
+        if (!built_) {
+            build();
+        }
+
+        while (match_ == npos) {
+            current_ = probe_.next();
+            if (!current_) {
+                return {};
+            }
+            if (auto* b = table_.find(as_key<key_type>(invoke(probe_key_, std::as_const(*current_))))) {
+                match_ = b->first;
+            }
+        }
+
+        const auto idx = match_;
+        match_ = chain_[idx];
+        return item_type{*current_, rows_[idx]};
+    }
+};
+
+// Yields the items of the first flow whose keys do (semi join) or do not
+// (anti join) appear in the second flow
+template <bool Anti, typename Probe, typename Build, typename ProbeKey, typename BuildKey>
+struct semi_join_adaptor
+    : flow_base<semi_join_adaptor<Anti, Probe, Build, ProbeKey, BuildKey>>
+{
+private:
+    using key_type = join_key_t<Build, BuildKey>;
+
+    Probe probe_;
+    Build build_;
+    FLOW_NO_UNIQUE_ADDRESS ProbeKey probe_key_;
+    FLOW_NO_UNIQUE_ADDRESS BuildKey build_key_;
+    hash_set<key_type> keys_;
+    bool built_ = false;
+
+public:
+    semi_join_adaptor(Probe&& probe, Build&& build, ProbeKey&& probe_key, BuildKey&& build_key)
+        : probe_(std::move(probe)),
+          build_(std::move(build)),
+          probe_key_(std::move(probe_key)),
+          build_key_(std::move(build_key))
+    {}
+
+    auto next() -> next_t<Probe>
+    {
+        if (!built_) {
+            build_.for_each([this](auto&& item) {
+                keys_.insert(invoke(build_key_, std::as_const(item)));
+            });
+            built_ = true;
+        }
+
+        while (auto m = probe_.next()) {
+            const bool found = keys_.contains(as_key<key_type>(invoke(probe_key_, std::as_const(*m))));
+            if (found != Anti) {
+                return m;
+            }
+        }
+        return {};
+    }
+};
+
+// Joins two flows which are both sorted by key. For each run of equal keys,
+// yields every pairing of a left item with a right item. Runs in the right
+// flow are revisited using subflows, so no buffering is needed.
+template <typename Left, typename Right, typename LeftKey, typename RightKey, typename Cmp>
+struct merge_join_adaptor
+    : flow_base<merge_join_adaptor<Left, Right, LeftKey, RightKey, Cmp>>
+{
+private:
+    using item_type = std::pair<join_item_t<Left>, join_item_t<Right>>;
+
+    Left left_;
+    Right right_;
+    FLOW_NO_UNIQUE_ADDRESS LeftKey left_key_;
+    FLOW_NO_UNIQUE_ADDRESS RightKey right_key_;
+    FLOW_NO_UNIQUE_ADDRESS Cmp cmp_;
+
+    next_t<Left> lhead_{};
+    next_t<Right> rhead_{};
+    maybe<subflow_t<Right>> run_{};
+    bool primed_ = false;
+
+    constexpr auto lkey() -> decltype(auto)
+    {
+        return invoke(left_key_, std::as_const(*lhead_));
+    }
+
+    constexpr auto rkey(value_t<Right> const& item) -> decltype(auto)
+    {
+        return invoke(right_key_, item);
+    }
+
+    constexpr auto make_item(join_item_t<Right> r) -> item_type
+    {
+        return item_type{*lhead_, FLOW_FWD(r)};
+    }
+
+public:
+    constexpr merge_join_adaptor(Left&& left, Right&& right, LeftKey&& left_key,
+                                 RightKey&& right_key, Cmp&& cmp)
+        : left_(std::move(left)),
+          right_(std::move(right)),
+          left_key_(std::move(left_key)),
+          right_key_(std::move(right_key)),
+          cmp_(std::move(cmp))
+    {}
+
+    constexpr auto next() -> maybe<item_type>
+    {
+        if (!primed_) {
+            lhead_ = left_.next();
+            rhead_ = right_.next();
+            primed_ = true;
+        }
+
+        while (true) {
+            // Continue pairing the current left item with the rest of the run
+            if (run_) {
+                auto m = run_->next();
+                if (m && !invoke(cmp_, rkey(std::as_const(*rhead_)), rkey(std::as_const(*m)))) {
+                    return make_item(*std::move(m));
+                }
+                // End of the run: the next left item may have the same key,
+                // in which case we go round again from the run head
+                run_.reset();
+                lhead_ = left_.next();
+            }
+
+            if (!lhead_ || !rhead_) {
+                return {};
+            }
+
+            if (invoke(cmp_, lkey(), rkey(std::as_const(*rhead_)))) {
+                lhead_ = left_.next();
+            } else if (invoke(cmp_, rkey(std::as_const(*rhead_)), lkey())) {
+                rhead_ = right_.next();
+            } else {
+                run_ = right_.subflow();
+                return make_item(*rhead_);
+            }
+        }
+    }
+};
+
+struct hash_join_fn {
+    template <typename Flowable1, typename Flowable2, typename Key1, typename Key2>
+    auto operator()(Flowable1&& probe, Flowable2&& build, Key1 probe_key, Key2 build_key) const
+    {
+        static_assert(is_flowable<Flowable1> && is_flowable<Flowable2>,
+                      "Arguments to flow::hash_join() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(probe)))
+            .hash_join(FLOW_FWD(build), std::move(probe_key), std::move(build_key));
+    }
+};
+
+struct semi_join_fn {
+    template <typename Flowable1, typename Flowable2, typename Key1, typename Key2>
+    auto operator()(Flowable1&& probe, Flowable2&& build, Key1 probe_key, Key2 build_key) const
+    {
+        static_assert(is_flowable<Flowable1> && is_flowable<Flowable2>,
+                      "Arguments to flow::semi_join() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(probe)))
+            .semi_join(FLOW_FWD(build), std::move(probe_key), std::move(build_key));
+    }
+};
+
+struct anti_join_fn {
+    template <typename Flowable1, typename Flowable2, typename Key1, typename Key2>
+    auto operator()(Flowable1&& probe, Flowable2&& build, Key1 probe_key, Key2 build_key) const
+    {
+        static_assert(is_flowable<Flowable1> && is_flowable<Flowable2>,
+                      "Arguments to flow::anti_join() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(probe)))
+            .anti_join(FLOW_FWD(build), std::move(probe_key), std::move(build_key));
+    }
+};
+
+struct merge_join_fn {
+    template <typename Flowable1, typename Flowable2, typename Key1, typename Key2,
+              typename Cmp = less>
+    constexpr auto operator()(Flowable1&& left, Flowable2&& right, Key1 left_key,
+                              Key2 right_key, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable1> && is_flowable<Flowable2>,
+                      "Arguments to flow::merge_join() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(left)))
+            .merge_join(FLOW_FWD(right), std::move(left_key), std::move(right_key),
+                        std::move(cmp));
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto hash_join = detail::hash_join_fn{};
+
+inline constexpr auto semi_join = detail::semi_join_fn{};
+
+inline constexpr auto anti_join = detail::anti_join_fn{};
+
+inline constexpr auto merge_join = detail::merge_join_fn{};
+
+template <typename D>
+template <typename Flowable, typename ProbeKey, typename BuildKey>
+auto flow_base<D>::hash_join(Flowable&& other, ProbeKey probe_key, BuildKey build_key) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "First argument to hash_join() must be a Flowable type");
+    using build_t = std::decay_t<flow_t<Flowable>>;
+    static_assert(!is_infinite_flow<build_t>,
+                  "The second flow passed to hash_join() cannot be infinite");
+    static_assert(std::is_invocable_v<ProbeKey&, value_t<D> const&>,
+                  "Incompatible key function passed to hash_join() for the first flow");
+    static_assert(std::is_invocable_v<BuildKey&, value_t<build_t> const&>,
+                  "Incompatible key function passed to hash_join() for the second flow");
+    static_assert(std::is_convertible_v<std::invoke_result_t<ProbeKey&, value_t<D> const&>,
+                                        detail::join_key_t<build_t, BuildKey>>,
+                  "Key types passed to hash_join() are not compatible");
+
+    return detail::hash_join_adaptor<D, build_t, ProbeKey, BuildKey>(
+        consume(), FLOW_COPY(flow::from(FLOW_FWD(other))),
+        std::move(probe_key), std::move(build_key));
+}
+
+template <typename D>
+template <typename Flowable, typename ProbeKey, typename BuildKey>
+auto flow_base<D>::semi_join(Flowable&& other, ProbeKey probe_key, BuildKey build_key) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "First argument to semi_join() must be a Flowable type");
+    using build_t = std::decay_t<flow_t<Flowable>>;
+    static_assert(!is_infinite_flow<build_t>,
+                  "The second flow passed to semi_join() cannot be infinite");
+    static_assert(std::is_convertible_v<std::invoke_result_t<ProbeKey&, value_t<D> const&>,
+                                        detail::join_key_t<build_t, BuildKey>>,
+                  "Key types passed to semi_join() are not compatible");
+
+    return detail::semi_join_adaptor<false, D, build_t, ProbeKey, BuildKey>(
+        consume(), FLOW_COPY(flow::from(FLOW_FWD(other))),
+        std::move(probe_key), std::move(build_key));
+}
+
+template <typename D>
+template <typename Flowable, typename ProbeKey, typename BuildKey>
+auto flow_base<D>::anti_join(Flowable&& other, ProbeKey probe_key, BuildKey build_key) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "First argument to anti_join() must be a Flowable type");
+    using build_t = std::decay_t<flow_t<Flowable>>;
+    static_assert(!is_infinite_flow<build_t>,
+                  "The second flow passed to anti_join() cannot be infinite");
+    static_assert(std::is_convertible_v<std::invoke_result_t<ProbeKey&, value_t<D> const&>,
+                                        detail::join_key_t<build_t, BuildKey>>,
+                  "Key types passed to anti_join() are not compatible");
+
+    return detail::semi_join_adaptor<true, D, build_t, ProbeKey, BuildKey>(
+        consume(), FLOW_COPY(flow::from(FLOW_FWD(other))),
+        std::move(probe_key), std::move(build_key));
+}
+
+template <typename D>
+template <typename Flowable, typename LeftKey, typename RightKey, typename Cmp>
+constexpr auto flow_base<D>::merge_join(Flowable&& other, LeftKey left_key,
+                                        RightKey right_key, Cmp cmp) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "First argument to merge_join() must be a Flowable type");
+    using right_t = std::decay_t<flow_t<Flowable>>;
+    static_assert(is_multipass_flow<right_t>,
+                  "The second flow passed to merge_join() must be multipass");
+    using lkey_t = std::invoke_result_t<LeftKey&, value_t<D> const&>;
+    using rkey_t = std::invoke_result_t<RightKey&, value_t<right_t> const&>;
+    static_assert(std::is_invocable_r_v<bool, Cmp&, lkey_t, rkey_t> &&
+                  std::is_invocable_r_v<bool, Cmp&, rkey_t, lkey_t> &&
+                  std::is_invocable_r_v<bool, Cmp&, rkey_t, rkey_t>,
+                  "Incompatible comparator passed to merge_join()");
+
+    return detail::merge_join_adaptor<D, right_t, LeftKey, RightKey, Cmp>(
+        consume(), FLOW_COPY(flow::from(FLOW_FWD(other))),
+        std::move(left_key), std::move(right_key), std::move(cmp));
+}
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #define FLOW_OP_MAP_HPP_INCLUDED
 
 #include <flow/core/flow_base.hpp>
+#include <flow/op/map_filter.hpp>
 
 namespace flow {
 
@@ -27,6 +28,7 @@ template <typename Flow, typename Func>
 struct map_adaptor : flow_base<map_adaptor<Flow, Func>> {
 
     static constexpr bool is_infinite = is_infinite_flow<Flow>;
+    static constexpr bool is_random_access = is_random_access_flow<Flow>;
 
     using item_type = std::invoke_result_t<Func&, item_t<Flow>>;
 
@@ -71,6 +73,11 @@ struct map_adaptor : flow_base<map_adaptor<Flow, Func>> {
         return flow_.size();
     }
 
+    constexpr auto fuse() && -> map_filter_adaptor<Flow, map_stage<Func>>
+    {
+        return {std::move(flow_), std::tuple<map_stage<Func>>{{std::move(func_)}}};
+    }
+
 private:
     Flow flow_;
     FLOW_NO_UNIQUE_ADDRESS Func func_;
@@ -94,7 +101,11 @@ constexpr auto flow_base<D>::map(Func func) &&
     static_assert(!std::is_void_v<std::invoke_result_t<Func&, item_t<D>>>,
         "Map cannot be used with a function returning void");
 
-    return detail::map_adaptor<D, Func>(consume(), std::move(func));
+    if constexpr (detail::is_fusable<D>) {
+        return consume().fuse().then(detail::map_stage<Func>{std::move(func)});
+    } else {
+        return detail::map_adaptor<D, Func>(consume(), std::move(func));
+    }
 }
 
 /// @endcond
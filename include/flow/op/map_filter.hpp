@@ -0,0 +1,189 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_MAP_FILTER_HPP_INCLUDED
+#define FLOW_OP_MAP_FILTER_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+#include <tuple>
+
+//
+// When map() or filter() is called on a flow which is itself the result of
+// map() or filter(), the two are fused into a single map_filter_adaptor which
+// holds a tuple of stages. This keeps adaptor types shallow however long the
+// chain gets, and gives try_fold() a single loop body.
+//
+
+namespace flow::detail {
+
+template <typename Func>
+struct map_stage {
+    FLOW_NO_UNIQUE_ADDRESS Func fn;
+};
+
+template <typename Pred>
+struct filter_stage {
+    FLOW_NO_UNIQUE_ADDRESS Pred fn;
+};
+
+// The same stage, referring to (rather than owning) its function
+template <typename Stage>
+struct stage_ref;
+
+template <typename Func>
+struct stage_ref<map_stage<Func>> {
+    using type = map_stage<function_ref<Func>>;
+};
+
+template <typename Pred>
+struct stage_ref<filter_stage<Pred>> {
+    using type = filter_stage<function_ref<Pred>>;
+};
+
+template <typename Stage>
+using stage_ref_t = typename stage_ref<Stage>::type;
+
+// The item type produced by running a T through each of the stages in turn
+template <typename T, typename... Stages>
+struct stages_result {
+    using type = T;
+};
+
+template <typename T, typename Func, typename... Rest>
+struct stages_result<T, map_stage<Func>, Rest...>
+    : stages_result<std::invoke_result_t<Func&, T>, Rest...> {};
+
+template <typename T, typename Pred, typename... Rest>
+struct stages_result<T, filter_stage<Pred>, Rest...>
+    : stages_result<T, Rest...> {};
+
+template <typename>
+inline constexpr bool is_map_stage = false;
+
+template <typename Func>
+inline constexpr bool is_map_stage<map_stage<Func>> = true;
+
+template <typename F, typename = void>
+inline constexpr bool is_fusable = false;
+
+template <typename F>
+inline constexpr bool is_fusable<F, std::void_t<decltype(std::declval<F>().fuse())>> = true;
+
+template <typename Flow, typename... Stages>
+struct map_filter_adaptor : flow_base<map_filter_adaptor<Flow, Stages...>> {
+private:
+    // With no filters in the chain, we can pass through the properties of
+    // the underlying flow, just as map() does
+    static constexpr bool only_maps = (is_map_stage<Stages> && ...);
+
+public:
+    static constexpr bool is_infinite = only_maps && is_infinite_flow<Flow>;
+    static constexpr bool is_random_access = only_maps && is_random_access_flow<Flow>;
+
+    using item_type = typename stages_result<item_t<Flow>, Stages...>::type;
+
+    constexpr map_filter_adaptor(Flow&& flow, std::tuple<Stages...>&& stages)
+        : flow_(std::move(flow)),
+          stages_(std::move(stages))
+    {}
+
+    constexpr auto next() -> maybe<item_type>
+    {
+        if constexpr (is_infinite) {
+            return run<0>(*flow_.next());
+        } else {
+            while (auto m = flow_.next()) {
+                if (auto r = run<0>(*std::move(m))) {
+                    return r;
+                }
+            }
+            return {};
+        }
+    }
+
+    template <bool B = only_maps>
+    constexpr auto advance(dist_t dist) -> std::enable_if_t<B, maybe<item_type>>
+    {
+        if (auto m = flow_.advance(dist)) {
+            return run<0>(*std::move(m));
+        }
+        return {};
+    }
+
+    template <bool B = only_maps && is_reversible_flow<Flow>>
+    constexpr auto next_back() -> std::enable_if_t<B, maybe<item_type>>
+    {
+        if (auto m = flow_.next_back()) {
+            return run<0>(*std::move(m));
+        }
+        return {};
+    }
+
+    template <typename Func, typename Init>
+    constexpr auto try_fold(Func func, Init init) -> Init
+    {
+        return flow_.try_fold([this, &func](Init acc, next_t<Flow>&& m) -> Init {
+            if (auto r = run<0>(*std::move(m))) {
+                return invoke(func, std::move(acc), std::move(r));
+            }
+            return acc;
+        }, std::move(init));
+    }
+
+    template <typename F = Flow>
+    constexpr auto subflow() & -> map_filter_adaptor<subflow_t<F>, stage_ref_t<Stages>...>
+    {
+        return {flow_.subflow(), std::apply([](auto&... stages) {
+            return std::tuple<stage_ref_t<Stages>...>{{stages.fn}...};
+        }, stages_)};
+    }
+
+    template <bool B = only_maps && is_sized_flow<Flow>>
+    constexpr auto size() const -> std::enable_if_t<B, dist_t>
+    {
+        return flow_.size();
+    }
+
+    constexpr auto fuse() && -> map_filter_adaptor&&
+    {
+        return std::move(*this);
+    }
+
+    template <typename Stage>
+    constexpr auto then(Stage&& stage) && -> map_filter_adaptor<Flow, Stages..., Stage>
+    {
+        return {std::move(flow_),
+                std::tuple_cat(std::move(stages_), std::tuple<Stage>{std::move(stage)})};
+    }
+
+private:
+    // Runs `item` through the stages from index I onwards, returning an
+    // empty maybe if a filter rejects it
+    template <std::size_t I, typename T>
+    constexpr auto run(T&& item) -> maybe<item_type>
+    {
+        if constexpr (I == sizeof...(Stages)) {
+            return maybe<item_type>(FLOW_FWD(item));
+        } else {
+            auto& stage = std::get<I>(stages_);
+            if constexpr (is_map_stage<remove_cvref_t<decltype(stage)>>) {
+                return run<I + 1>(invoke(stage.fn, FLOW_FWD(item)));
+            } else {
+                if (invoke(stage.fn, std::as_const(item))) {
+                    return run<I + 1>(FLOW_FWD(item));
+                }
+                return {};
+            }
+        }
+    }
+
+    Flow flow_;
+    std::tuple<Stages...> stages_;
+};
+
+}
+
+#endif
@@ -150,6 +150,15 @@ struct tuple_getter {
     }
 };
 
+// Flows over columnar storage (see from_columns()) can hand out a single
+// column directly, rather than building each row only to discard most of it
+template <typename F, std::size_t N, typename = void>
+inline constexpr bool has_column_projection = false;
+
+template <typename F, std::size_t N>
+inline constexpr bool has_column_projection<
+    F, N, std::void_t<decltype(std::declval<F>().template column<N>())>> = true;
+
 } // namespace detail
 
 template <std::size_t N>
@@ -162,7 +171,11 @@ constexpr auto flow_base<D>::elements() &&
     static_assert(std::is_invocable_v<detail::tuple_getter<N>&, item_t<D>>,
                   "Flow's item type is not tuple-like");
 
-    return consume().map(detail::tuple_getter<N>{});
+    if constexpr (detail::has_column_projection<D, N>) {
+        return consume().template column<N>();
+    } else {
+        return consume().map(detail::tuple_getter<N>{});
+    }
 }
 
 // keys
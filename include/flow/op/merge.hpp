@@ -0,0 +1,281 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_MERGE_HPP_INCLUDED
+#define FLOW_OP_MERGE_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+#include <array>
+#include <tuple>
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+template <typename Cmp, typename... Flows>
+struct merge_adaptor : flow_base<merge_adaptor<Cmp, Flows...>> {
+private:
+    static constexpr std::size_t N = sizeof...(Flows);
+
+    template <typename, typename...>
+    friend struct merge_adaptor;
+
+    // All the flows have the same item type, so we can keep their current
+    // items in a plain array rather than a tuple
+    using next_type = std::common_type_t<next_t<Flows>...>;
+
+    FLOW_NO_UNIQUE_ADDRESS Cmp cmp_;
+    std::tuple<Flows...> flows_;
+    std::array<next_type, N> heads_{};
+    bool primed_ = false;
+
+    template <std::size_t... I>
+    constexpr void prime(std::index_sequence<I...>)
+    {
+        ((heads_[I] = std::get<I>(flows_).next()), ...);
+        primed_ = true;
+    }
+
+    template <std::size_t... I>
+    constexpr void refill(std::size_t idx, std::index_sequence<I...>)
+    {
+        (void) ((I == idx && (heads_[I] = std::get<I>(flows_).next(), true)) || ...);
+    }
+
+public:
+    constexpr explicit merge_adaptor(Cmp cmp, Flows&&... flows)
+        : cmp_(std::move(cmp)),
+          flows_(std::move(flows)...)
+    {}
+
+    constexpr auto next() -> next_type
+    {
+        if (!primed_) {
+            prime(std::index_sequence_for<Flows...>{});
+        }
+
+        // Find the smallest head. Ties go to the earliest flow, so the
+        // merge is stable.
+        std::size_t best = N;
+        for (std::size_t i = 0; i < N; i++) {
+            if (heads_[i] && (best == N || invoke(cmp_, *heads_[i], *heads_[best]))) {
+                best = i;
+            }
+        }
+
+        if (best == N) {
+            return {};
+        }
+
+        auto item = std::move(heads_[best]);
+        refill(best, std::index_sequence_for<Flows...>{});
+        return item;
+    }
+
+    template <bool B = (is_multipass_flow<Flows> && ...),
+              typename = std::enable_if_t<B>>
+    constexpr auto subflow() & -> merge_adaptor<function_ref<Cmp>, subflow_t<Flows>...>
+    {
+        auto s = std::apply([this](auto&... args) {
+            return merge_adaptor<function_ref<Cmp>, subflow_t<Flows>...>(cmp_, args.subflow()...);
+        }, flows_);
+        s.heads_ = heads_;
+        s.primed_ = primed_;
+        return s;
+    }
+
+    template <bool B = (is_sized_flow<Flows> && ...),
+              typename = std::enable_if_t<B>>
+    [[nodiscard]] constexpr auto size() const -> dist_t
+    {
+        dist_t total = std::apply([](auto const&... args) {
+            return (dist_t{0} + ... + args.size());
+        }, flows_);
+        for (auto const& h : heads_) {
+            total += static_cast<dist_t>(h.has_value());
+        }
+        return total;
+    }
+};
+
+struct merge_fn {
+    template <typename Cmp, typename Flowable0, typename... Flowables>
+    constexpr auto operator()(Cmp cmp, Flowable0&& flowable0, Flowables&&... flowables) const
+    {
+        static_assert(is_flowable<Flowable0> && (is_flowable<Flowables> && ...),
+                      "All arguments to flow::merge() after the comparator must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable0)))
+            .merge(std::move(cmp), FLOW_FWD(flowables)...);
+    }
+};
+
+// A "loser tree" (tournament tree) for merging a runtime number of flows.
+// Each internal node records the loser of the match played there, with the
+// overall winner stored at index 0. Replacing the winner requires only
+// log2(N) comparisons along the path from its leaf to the root.
+template <typename Flow, typename Cmp>
+struct merge_all_adaptor : flow_base<merge_all_adaptor<Flow, Cmp>> {
+
+    merge_all_adaptor(std::vector<Flow>&& flows, Cmp cmp)
+        : flows_(std::move(flows)),
+          cmp_(std::move(cmp))
+    {}
+
+    auto next() -> next_t<Flow>
+    {
+        if (!primed_) {
+            prime();
+        }
+
+        if (flows_.empty()) {
+            return {};
+        }
+
+        const auto winner = tree_[0];
+        if (!heads_[winner]) {
+            return {};
+        }
+
+        auto item = std::move(heads_[winner]);
+        heads_[winner] = flows_[winner].next();
+        replay(winner);
+        return item;
+    }
+
+    template <typename F = Flow,
+              typename = std::enable_if_t<is_sized_flow<F>>>
+    [[nodiscard]] auto size() const -> dist_t
+    {
+        dist_t total = 0;
+        for (std::size_t i = 0; i < flows_.size(); i++) {
+            total += flows_[i].size();
+            if (primed_ && heads_[i]) {
+                ++total;
+            }
+        }
+        return total;
+    }
+
+private:
+    static constexpr std::size_t none = std::size_t(-1);
+
+    // Returns true if the head of flow i should come before that of flow j.
+    // Exhausted flows lose to everything; ties go to the earlier flow.
+    auto beats(std::size_t i, std::size_t j) -> bool
+    {
+        if (!heads_[i]) {
+            return false;
+        }
+        if (!heads_[j]) {
+            return true;
+        }
+        if (invoke(cmp_, *heads_[i], *heads_[j])) {
+            return true;
+        }
+        return !invoke(cmp_, *heads_[j], *heads_[i]) && i < j;
+    }
+
+    void replay(std::size_t leaf)
+    {
+        const std::size_t k = flows_.size();
+        auto winner = leaf;
+        for (auto node = (leaf + k) / 2; node > 0; node /= 2) {
+            if (beats(tree_[node], winner)) {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+    }
+
+    void prime()
+    {
+        const std::size_t k = flows_.size();
+        heads_.reserve(k);
+        for (auto& f : flows_) {
+            heads_.push_back(f.next());
+        }
+
+        // Play the initial tournament. Each leaf climbs until it finds an
+        // empty node to wait in; the final leaf to arrive at the root is the
+        // overall winner.
+        tree_.assign(k, none);
+        for (std::size_t leaf = 0; leaf < k; leaf++) {
+            auto winner = leaf;
+            auto node = (leaf + k) / 2;
+            for (; node > 0; node /= 2) {
+                if (tree_[node] == none) {
+                    tree_[node] = winner;
+                    break;
+                }
+                if (beats(tree_[node], winner)) {
+                    std::swap(tree_[node], winner);
+                }
+            }
+            if (node == 0) {
+                tree_[0] = winner;
+            }
+        }
+
+        primed_ = true;
+    }
+
+    std::vector<Flow> flows_;
+    FLOW_NO_UNIQUE_ADDRESS Cmp cmp_;
+    std::vector<next_t<Flow>> heads_;
+    std::vector<std::size_t> tree_;
+    bool primed_ = false;
+};
+
+struct merge_all_fn {
+    template <typename Flow, typename Cmp = less>
+    auto operator()(std::vector<Flow> flows, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flow<Flow>,
+                      "flow::merge_all() requires a std::vector of flows");
+        static_assert(std::is_invocable_r_v<bool, Cmp&, item_t<Flow>, item_t<Flow>>,
+                      "Incompatible comparator passed to flow::merge_all()");
+        return merge_all_adaptor<Flow, Cmp>(std::move(flows), std::move(cmp));
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto merge = detail::merge_fn{};
+
+/// Given a `std::vector` of flows, each of which is sorted according to
+/// `cmp`, returns a new flow which yields the items of all the flows in
+/// sorted order.
+///
+/// This is like `merge()`, but for a number of flows which is only known at
+/// run-time. A tournament tree is used to select the next item, so each
+/// step takes `O(log k)` comparisons for `k` flows. Like `merge()`, the merge
+/// is stable.
+///
+/// @param flows A `std::vector` of flows to merge
+/// @param cmp Comparator according to which all the flows are sorted,
+///            defaulting to `flow::less`
+/// @return A new merge adaptor
+inline constexpr auto merge_all = detail::merge_all_fn{};
+
+template <typename D>
+template <typename Cmp, typename... Flowables>
+constexpr auto flow_base<D>::merge(Cmp cmp, Flowables&&... flowables) &&
+{
+    static_assert((is_flowable<Flowables> && ...),
+                  "All arguments to merge() after the comparator must be Flowable");
+    static_assert((std::is_same_v<item_t<D>, flow_item_t<Flowables>> && ...),
+                  "Flows used with merge() must have the exact same item type");
+    static_assert(std::is_invocable_r_v<bool, Cmp&, item_t<D>, item_t<D>>,
+                  "Incompatible comparator passed to merge()");
+
+    return detail::merge_adaptor<Cmp, D, std::decay_t<flow_t<Flowables>>...>(
+        std::move(cmp), consume(), FLOW_COPY(flow::from(FLOW_FWD(flowables)))...);
+}
+
+}
+
+#endif
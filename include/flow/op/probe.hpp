@@ -0,0 +1,376 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_PROBE_HPP_INCLUDED
+#define FLOW_OP_PROBE_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+//
+// probe() records statistics about a pipeline stage when the library is built
+// with FLOW_INSTRUMENTED defined. Otherwise it returns the flow unchanged, and
+// none of the machinery below exists.
+//
+
+#ifdef FLOW_INSTRUMENTED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#endif
+
+namespace flow {
+
+#ifdef FLOW_INSTRUMENTED
+inline constexpr bool instrumented = true;
+#else
+inline constexpr bool instrumented = false;
+#endif
+
+#ifdef FLOW_INSTRUMENTED
+
+/// Timing is recorded for one in every `probe_sample_interval` calls to
+/// `next()`, and scaled up to estimate the total
+inline constexpr std::uint64_t probe_sample_interval = 64;
+
+/// Statistics recorded by `probe()` for one named pipeline stage.
+///
+/// Times are inclusive: they include the time spent in every stage upstream
+/// of the probe.
+struct probe_stats {
+    explicit probe_stats(std::string name) : name(std::move(name)) {}
+
+    const std::string name;
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> items{0};
+    std::atomic<std::uint64_t> sampled_calls{0};
+    std::atomic<std::uint64_t> sampled_ns{0};
+    // Nanoseconds since the registry was created
+    std::atomic<std::int64_t> first_ns{-1};
+    std::atomic<std::int64_t> last_ns{0};
+    // The nearest probe upstream of this one, if any
+    std::atomic<probe_stats const*> upstream{nullptr};
+
+    /// Returns the estimated total time spent in `next()`, in nanoseconds
+    [[nodiscard]] auto estimated_ns() const -> std::uint64_t
+    {
+        const auto n = sampled_calls.load(std::memory_order_relaxed);
+        if (n == 0) {
+            return 0;
+        }
+        const double per_call = double(sampled_ns.load(std::memory_order_relaxed)) / double(n);
+        return static_cast<std::uint64_t>(per_call * double(calls.load(std::memory_order_relaxed)));
+    }
+
+    /// Returns the fraction of the upstream probe's items which reached this
+    /// one, for example the proportion of items passing a filter placed
+    /// between the two.
+    [[nodiscard]] auto selectivity() const -> maybe<double>
+    {
+        auto up = upstream.load(std::memory_order_relaxed);
+        if (!up) {
+            return {};
+        }
+        const auto in = up->items.load(std::memory_order_relaxed);
+        if (in == 0) {
+            return {};
+        }
+        return double(items.load(std::memory_order_relaxed)) / double(in);
+    }
+
+    void reset()
+    {
+        calls = 0;
+        items = 0;
+        sampled_calls = 0;
+        sampled_ns = 0;
+        first_ns = -1;
+        last_ns = 0;
+        upstream = nullptr;
+    }
+};
+
+/// The process-wide collection of probe statistics, keyed by name.
+///
+/// Probes with the same name share a single entry, so running a pipeline
+/// repeatedly accumulates its statistics.
+struct probe_registry {
+
+    using clock = std::chrono::steady_clock;
+
+    [[nodiscard]] static auto instance() -> probe_registry&
+    {
+        static probe_registry reg;
+        return reg;
+    }
+
+    /// Returns the entry for `name`, creating it if necessary. The reference
+    /// remains valid for the lifetime of the program.
+    auto get(std::string_view name) -> probe_stats&
+    {
+        std::lock_guard lock(mtx_);
+        for (auto& s : stages_) {
+            if (s.name == name) {
+                return s;
+            }
+        }
+        return stages_.emplace_back(std::string(name));
+    }
+
+    /// Calls `func` with each entry, in order of creation
+    template <typename Func>
+    void for_each(Func func) const
+    {
+        std::lock_guard lock(mtx_);
+        for (auto const& s : stages_) {
+            func(s);
+        }
+    }
+
+    /// Zeroes the statistics of every entry
+    void reset()
+    {
+        std::lock_guard lock(mtx_);
+        for (auto& s : stages_) {
+            s.reset();
+        }
+    }
+
+    [[nodiscard]] auto now_ns() const -> std::int64_t
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock::now() - epoch_).count();
+    }
+
+    /// Writes the statistics of every entry as a JSON object with a single
+    /// member, "stages", which is an array
+    void write_json(std::ostream& os) const
+    {
+        os << "{\"stages\":[";
+        bool first = true;
+        for_each([&](probe_stats const& s) {
+            os << (first ? "" : ",") << '{';
+            first = false;
+            write_fields(os, s);
+            os << '}';
+        });
+        os << "]}";
+    }
+
+    /// Writes the statistics in the Chrome trace event format, which can be
+    /// loaded by chrome://tracing or Perfetto. Each stage is a single complete
+    /// event spanning its first and last recorded calls.
+    void write_chrome_trace(std::ostream& os) const
+    {
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for_each([&](probe_stats const& s) {
+            const auto begin = s.first_ns.load(std::memory_order_relaxed);
+            if (begin < 0) {
+                return;
+            }
+            const auto end = s.last_ns.load(std::memory_order_relaxed);
+            os << (first ? "" : ",") << "{\"name\":";
+            first = false;
+            write_string(os, s.name);
+            os << ",\"cat\":\"flow\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+               << ",\"ts\":" << double(begin) / 1000.0
+               << ",\"dur\":" << double(end > begin ? end - begin : 0) / 1000.0
+               << ",\"args\":{";
+            write_fields(os, s);
+            os << "}}";
+        });
+        os << "]}";
+    }
+
+private:
+    probe_registry() = default;
+
+    static void write_string(std::ostream& os, std::string const& str)
+    {
+        constexpr char hex[] = "0123456789abcdef";
+        os << '"';
+        for (char c : str) {
+            if (c == '"' || c == '\\') {
+                os << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                os << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+            } else {
+                os << c;
+            }
+        }
+        os << '"';
+    }
+
+    static void write_fields(std::ostream& os, probe_stats const& s)
+    {
+        os << "\"name\":";
+        write_string(os, s.name);
+        os << ",\"calls\":" << s.calls.load(std::memory_order_relaxed)
+           << ",\"items\":" << s.items.load(std::memory_order_relaxed)
+           << ",\"estimated_ns\":" << s.estimated_ns()
+           << ",\"upstream\":";
+        if (auto up = s.upstream.load(std::memory_order_relaxed)) {
+            write_string(os, up->name);
+        } else {
+            os << "null";
+        }
+        os << ",\"selectivity\":";
+        if (auto sel = s.selectivity()) {
+            os << *sel;
+        } else {
+            os << "null";
+        }
+    }
+
+    mutable std::mutex mtx_;
+    std::deque<probe_stats> stages_;
+    clock::time_point epoch_ = clock::now();
+};
+
+namespace detail {
+
+// The probe whose next() is currently running on this thread, so that
+// probes further upstream can discover their downstream neighbour
+inline thread_local probe_stats* current_probe = nullptr;
+
+struct probe_scope {
+    probe_scope(probe_stats& stats, std::uint64_t call)
+        : stats_(stats),
+          outer_(current_probe),
+          sampled_(call % probe_sample_interval == 0)
+    {
+        if (call == 0) {
+            if (outer_) {
+                probe_stats const* expected = nullptr;
+                outer_->upstream.compare_exchange_strong(expected, &stats_);
+            }
+            stats_.first_ns = probe_registry::instance().now_ns();
+        }
+        current_probe = &stats_;
+        if (sampled_) {
+            start_ = probe_registry::clock::now();
+        }
+    }
+
+    probe_scope(probe_scope const&) = delete;
+    probe_scope& operator=(probe_scope const&) = delete;
+
+    ~probe_scope()
+    {
+        current_probe = outer_;
+        if (sampled_) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                probe_registry::clock::now() - start_).count();
+            stats_.sampled_calls.fetch_add(1, std::memory_order_relaxed);
+            stats_.sampled_ns.fetch_add(static_cast<std::uint64_t>(ns),
+                                        std::memory_order_relaxed);
+            stats_.last_ns = probe_registry::instance().now_ns();
+        }
+    }
+
+private:
+    probe_stats& stats_;
+    probe_stats* outer_;
+    bool sampled_;
+    probe_registry::clock::time_point start_{};
+};
+
+template <typename Flow>
+struct probe_adaptor : flow_base<probe_adaptor<Flow>> {
+
+    static constexpr bool is_infinite = is_infinite_flow<Flow>;
+    static constexpr bool is_random_access = is_random_access_flow<Flow>;
+
+    probe_adaptor(Flow&& flow, std::string_view name)
+        : flow_(std::move(flow)),
+          stats_(&probe_registry::instance().get(name))
+    {}
+
+    auto next() -> next_t<Flow>
+    {
+        return record([this] { return flow_.next(); });
+    }
+
+    template <bool B = is_reversible_flow<Flow>>
+    auto next_back() -> std::enable_if_t<B, next_t<Flow>>
+    {
+        return record([this] { return flow_.next_back(); });
+    }
+
+    template <bool B = is_random_access>
+    auto advance(dist_t dist) -> std::enable_if_t<B, next_t<Flow>>
+    {
+        return record([this, dist] { return flow_.advance(dist); });
+    }
+
+    // Items read through subflows are not counted
+    template <typename F = Flow>
+    constexpr auto subflow() & -> subflow_t<F>
+    {
+        return flow_.subflow();
+    }
+
+    template <bool B = is_sized_flow<Flow>>
+    constexpr auto size() const -> std::enable_if_t<B, dist_t>
+    {
+        return flow_.size();
+    }
+
+private:
+    template <typename Func>
+    auto record(Func func) -> next_t<Flow>
+    {
+        const auto call = stats_->calls.fetch_add(1, std::memory_order_relaxed);
+        auto m = [&] {
+            probe_scope scope(*stats_, call);
+            return func();
+        }();
+        if (m) {
+            stats_->items.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            stats_->last_ns = probe_registry::instance().now_ns();
+        }
+        return m;
+    }
+
+    Flow flow_;
+    probe_stats* stats_;
+};
+
+} // namespace detail
+
+#endif // FLOW_INSTRUMENTED
+
+inline constexpr auto probe = [](auto&& flowable, std::string_view name) {
+    static_assert(is_flowable<decltype(flowable)>,
+                  "Argument to flow::probe() must be a Flowable type");
+    return FLOW_COPY(flow::from(FLOW_FWD(flowable))).probe(name);
+};
+
+#ifdef FLOW_INSTRUMENTED
+template <typename D>
+constexpr auto flow_base<D>::probe(std::string_view name) &&
+{
+    return detail::probe_adaptor<D>(consume(), name);
+}
+#else
+// Returns by value, so that the result can safely be bound to a reference
+// (as in FLOW_FOR) even when this flow is a temporary
+template <typename D>
+constexpr auto flow_base<D>::probe(std::string_view) && -> D
+{
+    return consume();
+}
+#endif
+
+}
+
+#endif
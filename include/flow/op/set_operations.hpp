@@ -0,0 +1,310 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_SET_OPERATIONS_HPP_INCLUDED
+#define FLOW_OP_SET_OPERATIONS_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+namespace flow {
+
+namespace detail {
+
+// Given a flow whose current item is stored in `head`, moves forward until
+// `head` contains the first item which is not less than `value` (or the flow
+// is exhausted).
+//
+// For random-access flows we gallop: probe 1, 2, 4, ... items ahead using
+// (cheap) subflows, then binary search within the last step. Skipping over
+// `n` items then costs O(log n) comparisons rather than O(n).
+template <typename Flow, typename Cmp, typename T>
+constexpr void skip_less_than(Flow& flow, next_t<Flow>& head, T const& value, Cmp& cmp)
+{
+    if (!head || !invoke(cmp, *head, value)) {
+        return;
+    }
+
+    if constexpr (is_random_access_flow<Flow>) {
+        const dist_t n = flow.size();
+        const auto less_at = [&flow, &value, &cmp](dist_t i) -> bool {
+            auto s = flow.subflow();
+            return invoke(cmp, *s.advance(i + 1), value);
+        };
+
+        dist_t lo = 0;
+        dist_t hi = 1;
+        while (hi <= n && less_at(hi - 1)) {
+            lo = hi;
+            hi *= 2;
+        }
+        hi = min(hi, n);
+
+        while (lo < hi) {
+            const dist_t mid = lo + (hi - lo)/2;
+            if (less_at(mid)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        // All of the first `lo` remaining items are less than value
+        if (lo < n) {
+            head = flow.advance(lo + 1);
+        } else {
+            if (n > 0) {
+                (void) flow.advance(n);
+            }
+            head = {};
+        }
+    } else {
+        do {
+            head = flow.next();
+        } while (head && invoke(cmp, *head, value));
+    }
+}
+
+template <typename Flow1, typename Flow2, typename Cmp>
+struct set_op_base {
+    constexpr set_op_base(Flow1&& flow1, Flow2&& flow2, Cmp cmp)
+        : flow1_(std::move(flow1)),
+          flow2_(std::move(flow2)),
+          cmp_(std::move(cmp))
+    {}
+
+protected:
+    constexpr void prime()
+    {
+        if (!primed_) {
+            head1_ = flow1_.next();
+            head2_ = flow2_.next();
+            primed_ = true;
+        }
+    }
+
+    template <typename Self>
+    constexpr auto subflow_impl() -> Self
+    {
+        auto s = Self(flow1_.subflow(), flow2_.subflow(), cmp_);
+        s.head1_ = head1_;
+        s.head2_ = head2_;
+        s.primed_ = primed_;
+        return s;
+    }
+
+    Flow1 flow1_;
+    Flow2 flow2_;
+    FLOW_NO_UNIQUE_ADDRESS Cmp cmp_;
+    next_t<Flow1> head1_{};
+    next_t<Flow2> head2_{};
+    bool primed_ = false;
+
+    template <typename, typename, typename>
+    friend struct set_op_base;
+};
+
+template <typename Flow1, typename Flow2, typename Cmp>
+struct set_union_adaptor
+    : flow_base<set_union_adaptor<Flow1, Flow2, Cmp>>,
+      set_op_base<Flow1, Flow2, Cmp>
+{
+    using set_op_base<Flow1, Flow2, Cmp>::set_op_base;
+
+    constexpr auto next() -> next_t<Flow1>
+    {
+        this->prime();
+
+        auto& h1 = this->head1_;
+        auto& h2 = this->head2_;
+
+        if (!h1 && !h2) {
+            return {};
+        }
+
+        if (!h2 || (h1 && !invoke(this->cmp_, *h2, *h1))) {
+            // h1 is smaller or equal. If equal, output only one copy.
+            if (h2 && !invoke(this->cmp_, *h1, *h2)) {
+                h2 = this->flow2_.next();
+            }
+            auto item = std::move(h1);
+            h1 = this->flow1_.next();
+            return item;
+        }
+
+        auto item = std::move(h2);
+        h2 = this->flow2_.next();
+        return item;
+    }
+
+    template <bool B = is_multipass_flow<Flow1> && is_multipass_flow<Flow2>,
+              typename = std::enable_if_t<B>>
+    constexpr auto subflow() &
+    {
+        return this->template subflow_impl<
+            set_union_adaptor<subflow_t<Flow1>, subflow_t<Flow2>, function_ref<Cmp>>>();
+    }
+};
+
+template <typename Flow1, typename Flow2, typename Cmp>
+struct set_intersection_adaptor
+    : flow_base<set_intersection_adaptor<Flow1, Flow2, Cmp>>,
+      set_op_base<Flow1, Flow2, Cmp>
+{
+    using set_op_base<Flow1, Flow2, Cmp>::set_op_base;
+
+    constexpr auto next() -> next_t<Flow1>
+    {
+        this->prime();
+
+        auto& h1 = this->head1_;
+        auto& h2 = this->head2_;
+
+        while (h1 && h2) {
+            if (invoke(this->cmp_, *h1, *h2)) {
+                skip_less_than(this->flow1_, h1, *h2, this->cmp_);
+            } else if (invoke(this->cmp_, *h2, *h1)) {
+                skip_less_than(this->flow2_, h2, *h1, this->cmp_);
+            } else {
+                auto item = std::move(h1);
+                h1 = this->flow1_.next();
+                h2 = this->flow2_.next();
+                return item;
+            }
+        }
+
+        return {};
+    }
+
+    template <bool B = is_multipass_flow<Flow1> && is_multipass_flow<Flow2>,
+              typename = std::enable_if_t<B>>
+    constexpr auto subflow() &
+    {
+        return this->template subflow_impl<
+            set_intersection_adaptor<subflow_t<Flow1>, subflow_t<Flow2>, function_ref<Cmp>>>();
+    }
+};
+
+template <typename Flow1, typename Flow2, typename Cmp>
+struct set_difference_adaptor
+    : flow_base<set_difference_adaptor<Flow1, Flow2, Cmp>>,
+      set_op_base<Flow1, Flow2, Cmp>
+{
+    using set_op_base<Flow1, Flow2, Cmp>::set_op_base;
+
+    constexpr auto next() -> next_t<Flow1>
+    {
+        this->prime();
+
+        auto& h1 = this->head1_;
+        auto& h2 = this->head2_;
+
+        while (h1) {
+            skip_less_than(this->flow2_, h2, *h1, this->cmp_);
+
+            if (!h2 || invoke(this->cmp_, *h1, *h2)) {
+                auto item = std::move(h1);
+                h1 = this->flow1_.next();
+                return item;
+            }
+
+            // Equal items: drop both
+            h1 = this->flow1_.next();
+            h2 = this->flow2_.next();
+        }
+
+        return {};
+    }
+
+    template <bool B = is_multipass_flow<Flow1> && is_multipass_flow<Flow2>,
+              typename = std::enable_if_t<B>>
+    constexpr auto subflow() &
+    {
+        return this->template subflow_impl<
+            set_difference_adaptor<subflow_t<Flow1>, subflow_t<Flow2>, function_ref<Cmp>>>();
+    }
+};
+
+struct set_union_fn {
+    template <typename Flowable1, typename Flowable2, typename Cmp = less>
+    constexpr auto operator()(Flowable1&& flowable1, Flowable2&& flowable2, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable1> && is_flowable<Flowable2>,
+                      "Arguments to flow::set_union() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable1)))
+            .set_union(FLOW_FWD(flowable2), std::move(cmp));
+    }
+};
+
+struct set_intersection_fn {
+    template <typename Flowable1, typename Flowable2, typename Cmp = less>
+    constexpr auto operator()(Flowable1&& flowable1, Flowable2&& flowable2, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable1> && is_flowable<Flowable2>,
+                      "Arguments to flow::set_intersection() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable1)))
+            .set_intersection(FLOW_FWD(flowable2), std::move(cmp));
+    }
+};
+
+struct set_difference_fn {
+    template <typename Flowable1, typename Flowable2, typename Cmp = less>
+    constexpr auto operator()(Flowable1&& flowable1, Flowable2&& flowable2, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable1> && is_flowable<Flowable2>,
+                      "Arguments to flow::set_difference() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable1)))
+            .set_difference(FLOW_FWD(flowable2), std::move(cmp));
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto set_union = detail::set_union_fn{};
+
+inline constexpr auto set_intersection = detail::set_intersection_fn{};
+
+inline constexpr auto set_difference = detail::set_difference_fn{};
+
+template <typename D>
+template <typename Flowable, typename Cmp>
+constexpr auto flow_base<D>::set_union(Flowable&& other, Cmp cmp) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "Argument to set_union() must be a Flowable type");
+    static_assert(std::is_same_v<item_t<D>, flow_item_t<Flowable>>,
+                  "Flows used with set_union() must have the exact same item type");
+    return detail::set_union_adaptor<D, std::decay_t<flow_t<Flowable>>, Cmp>(
+        consume(), FLOW_COPY(flow::from(FLOW_FWD(other))), std::move(cmp));
+}
+
+template <typename D>
+template <typename Flowable, typename Cmp>
+constexpr auto flow_base<D>::set_intersection(Flowable&& other, Cmp cmp) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "Argument to set_intersection() must be a Flowable type");
+    static_assert(std::is_invocable_r_v<bool, Cmp&, item_t<D>, flow_item_t<Flowable>> &&
+                  std::is_invocable_r_v<bool, Cmp&, flow_item_t<Flowable>, item_t<D>>,
+                  "Incompatible comparator passed to set_intersection()");
+    return detail::set_intersection_adaptor<D, std::decay_t<flow_t<Flowable>>, Cmp>(
+        consume(), FLOW_COPY(flow::from(FLOW_FWD(other))), std::move(cmp));
+}
+
+template <typename D>
+template <typename Flowable, typename Cmp>
+constexpr auto flow_base<D>::set_difference(Flowable&& other, Cmp cmp) &&
+{
+    static_assert(is_flowable<Flowable>,
+                  "Argument to set_difference() must be a Flowable type");
+    static_assert(std::is_invocable_r_v<bool, Cmp&, item_t<D>, flow_item_t<Flowable>> &&
+                  std::is_invocable_r_v<bool, Cmp&, flow_item_t<Flowable>, item_t<D>>,
+                  "Incompatible comparator passed to set_difference()");
+    return detail::set_difference_adaptor<D, std::decay_t<flow_t<Flowable>>, Cmp>(
+        consume(), FLOW_COPY(flow::from(FLOW_FWD(other))), std::move(cmp));
+}
+
+}
+
+#endif
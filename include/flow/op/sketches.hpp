@@ -0,0 +1,519 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_SKETCHES_HPP_INCLUDED
+#define FLOW_OP_SKETCHES_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+#include <flow/core/hash_table.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional> // for std::hash
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+constexpr auto count_leading_zeros(std::uint64_t x) -> int
+{
+    if (x == 0) {
+        return 64;
+    }
+    int n = 0;
+    for (int shift = 32; shift > 0; shift /= 2) {
+        if ((x >> (64 - shift)) == 0) {
+            n += shift;
+            x <<= shift;
+        }
+    }
+    return n;
+}
+
+}
+
+/// A HyperLogLog sketch, estimating the number of distinct items inserted
+/// using `2^precision` bytes of memory. The relative standard error of the
+/// estimate is roughly `1.04/sqrt(2^precision)`; that is, about 1.6% with
+/// the default precision of 12.
+template <typename T, typename Hash = std::hash<T>>
+class hyperloglog {
+public:
+    explicit hyperloglog(int precision = 12)
+        : precision_(precision),
+          registers_(std::size_t{1} << precision)
+    {
+        assert(precision >= 4 && precision <= 18 &&
+               "HyperLogLog precision must be between 4 and 18");
+    }
+
+    void insert(T const& item)
+    {
+        const std::uint64_t h = detail::hash_mix(hash_(item));
+        const auto idx = static_cast<std::size_t>(h >> (64 - precision_));
+        // Setting the low bit ensures the rank is at most 64 - precision + 1
+        const std::uint64_t rest = (h << precision_) | (std::uint64_t{1} << (precision_ - 1));
+        const auto rank = static_cast<std::uint8_t>(detail::count_leading_zeros(rest) + 1);
+        registers_[idx] = std::max(registers_[idx], rank);
+    }
+
+    /// Combines the contents of `other`, which must have the same precision,
+    /// as if its items had been inserted into this sketch
+    void merge(hyperloglog const& other)
+    {
+        assert(precision_ == other.precision_ &&
+               "Cannot merge HyperLogLog sketches with different precisions");
+        for (std::size_t i = 0; i < registers_.size(); i++) {
+            registers_[i] = std::max(registers_[i], other.registers_[i]);
+        }
+    }
+
+    [[nodiscard]] auto estimate() const -> double
+    {
+        const auto m = static_cast<double>(registers_.size());
+
+        double sum = 0.0;
+        std::size_t zeros = 0;
+        for (auto r : registers_) {
+            sum += std::ldexp(1.0, -r);
+            zeros += (r == 0);
+        }
+
+        const double alpha = 0.7213 / (1.0 + 1.079 / m);
+        const double raw = alpha * m * m / sum;
+
+        // Use linear counting for small cardinalities, where HLL is biased
+        if (raw <= 2.5 * m && zeros > 0) {
+            return m * std::log(m / static_cast<double>(zeros));
+        }
+        return raw;
+    }
+
+private:
+    int precision_;
+    std::vector<std::uint8_t> registers_;
+    FLOW_NO_UNIQUE_ADDRESS Hash hash_{};
+};
+
+/// A KLL quantiles sketch. Items are held in a hierarchy of compactors; when
+/// a compactor fills up, it is sorted and every other item is promoted to the
+/// next level with double the weight. Memory use is `O(k)` items regardless
+/// of the number inserted, and the rank error is roughly `1.7/k`.
+template <typename T, typename Cmp = less>
+class kll_sketch {
+public:
+    explicit kll_sketch(int k = 200, Cmp cmp = Cmp{})
+        : k_(k),
+          cmp_(std::move(cmp)),
+          levels_(1)
+    {
+        assert(k >= 8 && "KLL parameter k must be at least 8");
+    }
+
+    void insert(T const& item)
+    {
+        levels_[0].push_back(item);
+        ++count_;
+        if (levels_[0].size() >= capacity(0)) {
+            compress();
+        }
+    }
+
+    /// Combines the contents of `other` as if its items had been inserted
+    /// into this sketch
+    void merge(kll_sketch const& other)
+    {
+        if (levels_.size() < other.levels_.size()) {
+            levels_.resize(other.levels_.size());
+        }
+        for (std::size_t h = 0; h < other.levels_.size(); h++) {
+            levels_[h].insert(levels_[h].end(),
+                              other.levels_[h].begin(), other.levels_[h].end());
+        }
+        count_ += other.count_;
+        compress();
+    }
+
+    /// Returns the number of items inserted
+    [[nodiscard]] auto count() const -> dist_t { return count_; }
+
+    /// Returns an item whose rank is approximately `q * count()`, or an
+    /// empty `maybe` if the sketch is empty
+    [[nodiscard]] auto quantile(double q) const -> maybe<T>
+    {
+        assert(q >= 0.0 && q <= 1.0 && "Quantile must be between 0 and 1");
+
+        auto items = weighted_items();
+        if (items.empty()) {
+            return {};
+        }
+
+        const double target = q * static_cast<double>(count_);
+        std::uint64_t cumulative = 0;
+        for (auto const& [item, weight] : items) {
+            cumulative += weight;
+            if (static_cast<double>(cumulative) >= target) {
+                return item;
+            }
+        }
+        return items.back().first;
+    }
+
+    /// Returns the approximate fraction of inserted items which compare
+    /// less than `value`
+    [[nodiscard]] auto rank(T const& value) const -> double
+    {
+        if (count_ == 0) {
+            return 0.0;
+        }
+        std::uint64_t below = 0;
+        for (std::size_t h = 0; h < levels_.size(); h++) {
+            for (auto const& item : levels_[h]) {
+                if (invoke(cmp_, item, value)) {
+                    below += std::uint64_t{1} << h;
+                }
+            }
+        }
+        return static_cast<double>(below) / static_cast<double>(count_);
+    }
+
+private:
+    auto capacity(std::size_t h) const -> std::size_t
+    {
+        const auto depth = static_cast<double>(levels_.size() - h - 1);
+        const auto cap = static_cast<std::size_t>(std::ceil(k_ * std::pow(2.0/3.0, depth)));
+        return std::max(cap, std::size_t{2});
+    }
+
+    void compress()
+    {
+        for (std::size_t h = 0; h < levels_.size(); h++) {
+            if (levels_[h].size() < capacity(h)) {
+                continue;
+            }
+            if (h + 1 == levels_.size()) {
+                levels_.emplace_back();
+            }
+
+            auto& level = levels_[h];
+            std::sort(level.begin(), level.end(), [this](T const& a, T const& b) {
+                return static_cast<bool>(invoke(cmp_, a, b));
+            });
+
+            // With an odd number of items, the last one stays behind
+            const std::size_t n = level.size() - level.size() % 2;
+            for (std::size_t i = next_coin(); i < n; i += 2) {
+                levels_[h + 1].push_back(std::move(level[i]));
+            }
+            level.erase(level.begin(), level.begin() + static_cast<std::ptrdiff_t>(n));
+        }
+    }
+
+    // Compaction must choose the odd or even items at random, or the
+    // estimates become biased. A cheap LCG is plenty here.
+    auto next_coin() -> std::size_t
+    {
+        rng_ = rng_ * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<std::size_t>(rng_ >> 63);
+    }
+
+    auto weighted_items() const -> std::vector<std::pair<T, std::uint64_t>>
+    {
+        std::vector<std::pair<T, std::uint64_t>> items;
+        for (std::size_t h = 0; h < levels_.size(); h++) {
+            for (auto const& item : levels_[h]) {
+                items.emplace_back(item, std::uint64_t{1} << h);
+            }
+        }
+        std::sort(items.begin(), items.end(), [this](auto const& a, auto const& b) {
+            return static_cast<bool>(invoke(cmp_, a.first, b.first));
+        });
+        return items;
+    }
+
+    int k_;
+    FLOW_NO_UNIQUE_ADDRESS Cmp cmp_;
+    std::vector<std::vector<T>> levels_;
+    dist_t count_ = 0;
+    std::uint64_t rng_ = 0x853c49e6748fea9bULL;
+};
+
+/// An item reported by `space_saving::top()`. The true number of occurrences
+/// of `item` lies between `count - error` and `count`.
+template <typename T>
+struct heavy_hitter {
+    T item;
+    dist_t count;
+    dist_t error;
+};
+
+/// A Space-Saving sketch, which tracks the (approximately) most frequent
+/// items using `k` counters. Any item occurring more than `n/k` times in a
+/// stream of `n` items is guaranteed to be tracked.
+template <typename T, typename Hash = std::hash<T>>
+class space_saving {
+public:
+    explicit space_saving(std::size_t k)
+        : k_(k)
+    {
+        assert(k > 0 && "space_saving requires at least one counter");
+        counters_.reserve(k);
+        index_.reserve(k);
+    }
+
+    void insert(T const& item)
+    {
+        if (auto* pos = index_.find(item)) {
+            ++counters_[*pos].count;
+            sift_down(*pos);
+            return;
+        }
+
+        if (counters_.size() < k_) {
+            counters_.push_back({item, 1, 0});
+            *index_.try_emplace(item).first = counters_.size() - 1;
+            sift_up(counters_.size() - 1);
+            return;
+        }
+
+        // Evict the item with the smallest count, which is at the top of
+        // the heap. The newcomer inherits its count as the error bound.
+        auto& victim = counters_.front();
+        index_.erase(victim.item);
+        victim.error = victim.count;
+        ++victim.count;
+        victim.item = item;
+        *index_.try_emplace(item).first = 0;
+        sift_down(0);
+    }
+
+    /// Combines the contents of `other` with this sketch, keeping the `k`
+    /// largest combined counts. An item tracked by only one of the sketches
+    /// may have occurred up to the other's smallest count times in the
+    /// other's stream, so that is added to both its count and its error.
+    void merge(space_saving const& other)
+    {
+        // Copy first, so that merging a sketch with itself works
+        std::vector<heavy_hitter<T>> theirs = other.counters_;
+        const dist_t min_theirs = min_count(other);
+        const dist_t min_ours = min_count(*this);
+
+        std::vector<heavy_hitter<T>> all = std::move(counters_);
+        counters_.clear();
+        index_.clear();
+
+        hash_table_t combined;
+        for (std::size_t i = 0; i < all.size(); i++) {
+            *combined.try_emplace(all[i].item).first = i;
+        }
+        std::vector<bool> matched(all.size(), false);
+        for (auto& c : theirs) {
+            if (auto* pos = combined.find(c.item)) {
+                all[*pos].count += c.count;
+                all[*pos].error += c.error;
+                matched[*pos] = true;
+            } else {
+                c.count += min_ours;
+                c.error += min_ours;
+                all.push_back(std::move(c));
+            }
+        }
+        for (std::size_t i = 0; i < matched.size(); i++) {
+            if (!matched[i]) {
+                all[i].count += min_theirs;
+                all[i].error += min_theirs;
+            }
+        }
+
+        sort_descending(all);
+        if (all.size() > k_) {
+            all.resize(k_);
+        }
+
+        for (auto& c : all) {
+            counters_.push_back(std::move(c));
+            *index_.try_emplace(counters_.back().item).first = counters_.size() - 1;
+            sift_up(counters_.size() - 1);
+        }
+    }
+
+    /// Returns the tracked items, most frequent first
+    [[nodiscard]] auto top() const -> std::vector<heavy_hitter<T>>
+    {
+        auto out = counters_;
+        sort_descending(out);
+        return out;
+    }
+
+private:
+    using hash_table_t = detail::hash_table<T, std::size_t, Hash>;
+
+    // The smallest count in a full sketch (the top of the heap), or zero if
+    // it has spare counters and so has seen every item exactly
+    static auto min_count(space_saving const& sk) -> dist_t
+    {
+        return sk.counters_.size() < sk.k_ ? 0 : sk.counters_.front().count;
+    }
+
+    static void sort_descending(std::vector<heavy_hitter<T>>& vec)
+    {
+        std::stable_sort(vec.begin(), vec.end(), [](auto const& a, auto const& b) {
+            return a.count > b.count;
+        });
+    }
+
+    // The counters form a binary min-heap on count, with index_ mapping each
+    // item to its position in the heap
+
+    void swap_counters(std::size_t i, std::size_t j)
+    {
+        using std::swap;
+        swap(counters_[i], counters_[j]);
+        *index_.find(counters_[i].item) = i;
+        *index_.find(counters_[j].item) = j;
+    }
+
+    void sift_up(std::size_t i)
+    {
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / 2;
+            if (counters_[parent].count <= counters_[i].count) {
+                break;
+            }
+            swap_counters(i, parent);
+            i = parent;
+        }
+    }
+
+    void sift_down(std::size_t i)
+    {
+        const std::size_t n = counters_.size();
+        while (true) {
+            std::size_t smallest = i;
+            for (std::size_t child : {2*i + 1, 2*i + 2}) {
+                if (child < n && counters_[child].count < counters_[smallest].count) {
+                    smallest = child;
+                }
+            }
+            if (smallest == i) {
+                break;
+            }
+            swap_counters(i, smallest);
+            i = smallest;
+        }
+    }
+
+    std::size_t k_;
+    std::vector<heavy_hitter<T>> counters_;
+    hash_table_t index_;
+};
+
+/// Function object which inserts an item into a sketch and returns the
+/// sketch, for use as the accumulator function of `fold()`:
+///
+/// `flow.fold(flow::sketch_insert, flow::hyperloglog<int>{})`
+inline constexpr struct sketch_insert_fn {
+    template <typename Sketch, typename T>
+    auto operator()(Sketch sketch, T const& item) const -> Sketch
+    {
+        sketch.insert(item);
+        return sketch;
+    }
+} sketch_insert;
+
+/// Function object which merges two sketches, for combining partial results
+/// computed separately (for example, in parallel):
+///
+/// `flow::from(partial_sketches).fold_first(flow::sketch_merge)`
+inline constexpr struct sketch_merge_fn {
+    template <typename Sketch>
+    auto operator()(Sketch sketch, Sketch const& other) const -> Sketch
+    {
+        sketch.merge(other);
+        return sketch;
+    }
+} sketch_merge;
+
+namespace detail {
+
+struct approx_count_distinct_op {
+    template <typename Flowable>
+    auto operator()(Flowable&& flowable, int precision = 12) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::approx_count_distinct() must be Flowable");
+        return flow::from(FLOW_FWD(flowable)).approx_count_distinct(precision);
+    }
+};
+
+struct approx_quantiles_op {
+    template <typename Flowable, typename Cmp = less>
+    auto operator()(Flowable&& flowable, int k = 200, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::approx_quantiles() must be Flowable");
+        return flow::from(FLOW_FWD(flowable)).approx_quantiles(k, std::move(cmp));
+    }
+};
+
+struct heavy_hitters_op {
+    template <typename Flowable>
+    auto operator()(Flowable&& flowable, std::size_t k) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::heavy_hitters() must be Flowable");
+        return flow::from(FLOW_FWD(flowable)).heavy_hitters(k);
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto approx_count_distinct = detail::approx_count_distinct_op{};
+
+inline constexpr auto approx_quantiles = detail::approx_quantiles_op{};
+
+inline constexpr auto heavy_hitters = detail::heavy_hitters_op{};
+
+template <typename D>
+auto flow_base<D>::approx_count_distinct(int precision) -> dist_t
+{
+    static_assert(!is_infinite_flow<D>,
+                  "Cannot call approx_count_distinct() on an infinite flow");
+
+    hyperloglog<value_t<D>> hll(precision);
+    derived().for_each([&hll](auto const& item) { hll.insert(item); });
+    return static_cast<dist_t>(std::llround(hll.estimate()));
+}
+
+template <typename D>
+template <typename Cmp>
+auto flow_base<D>::approx_quantiles(int k, Cmp cmp)
+{
+    static_assert(!is_infinite_flow<D>,
+                  "Cannot call approx_quantiles() on an infinite flow");
+    static_assert(std::is_invocable_r_v<bool, Cmp&, value_t<D> const&, value_t<D> const&>,
+                  "Incompatible comparator passed to approx_quantiles()");
+
+    kll_sketch<value_t<D>, Cmp> sketch(k, std::move(cmp));
+    derived().for_each([&sketch](auto const& item) { sketch.insert(item); });
+    return sketch;
+}
+
+template <typename D>
+auto flow_base<D>::heavy_hitters(std::size_t k)
+{
+    static_assert(!is_infinite_flow<D>,
+                  "Cannot call heavy_hitters() on an infinite flow");
+
+    space_saving<value_t<D>> sketch(k);
+    derived().for_each([&sketch](auto const& item) { sketch.insert(item); });
+    return sketch.top();
+}
+
+}
+
+#endif
@@ -0,0 +1,340 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_SORTED_HPP_INCLUDED
+#define FLOW_OP_SORTED_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <exception>
+#include <functional> // for std::less, std::greater
+#include <thread>
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+struct sorted_op {
+    template <typename Flowable, typename Cmp = less>
+    auto operator()(Flowable&& flowable, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::sorted() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable))).sorted(std::move(cmp));
+    }
+};
+
+struct par_sorted_op {
+    template <typename Flowable, typename Cmp = less>
+    auto operator()(Flowable&& flowable, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::par_sorted() must be Flowable");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable))).par_sorted(std::move(cmp));
+    }
+};
+
+struct top_k_op {
+    template <typename Flowable, typename Cmp = less>
+    auto operator()(Flowable&& flowable, dist_t k, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::top_k() must be Flowable");
+        return flow::from(FLOW_FWD(flowable)).top_k(k, std::move(cmp));
+    }
+};
+
+struct nth_element_op {
+    template <typename Flowable, typename Cmp = less>
+    auto operator()(Flowable&& flowable, dist_t n, Cmp cmp = Cmp{}) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::nth_element() must be Flowable");
+        return flow::from(FLOW_FWD(flowable)).nth_element(n, std::move(cmp));
+    }
+};
+
+// std:: algorithms call their comparator directly, so wrap it up so that
+// we can use anything invocable (e.g. pointers to members) as elsewhere
+template <typename Cmp>
+struct invoke_cmp {
+    Cmp& cmp;
+
+    template <typename T, typename U>
+    constexpr auto operator()(T const& lhs, U const& rhs) const -> bool
+    {
+        return static_cast<bool>(invoke(cmp, lhs, rhs));
+    }
+};
+
+template <typename T>
+inline constexpr bool is_radix_sortable =
+    std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+template <typename Cmp, typename T>
+inline constexpr bool is_ascending_cmp =
+    std::is_same_v<Cmp, less> ||
+    std::is_same_v<Cmp, std::less<>> ||
+    std::is_same_v<Cmp, std::less<T>>;
+
+template <typename Cmp, typename T>
+inline constexpr bool is_descending_cmp =
+    std::is_same_v<Cmp, greater> ||
+    std::is_same_v<Cmp, std::greater<>> ||
+    std::is_same_v<Cmp, std::greater<T>>;
+
+// Below this size, a comparison sort wins
+inline constexpr std::size_t radix_sort_threshold = 256;
+
+// LSD radix sort, one byte at a time. Passes in which every element has the
+// same digit are skipped entirely, so (for example) sorting small positive
+// 64-bit values only touches the low-order bytes.
+template <typename T>
+void radix_sort(std::vector<T>& vec)
+{
+    using U = std::make_unsigned_t<T>;
+    constexpr std::size_t num_passes = sizeof(T);
+    constexpr U sign_bit = std::is_signed_v<T> ?
+        static_cast<U>(U{1} << (sizeof(T) * CHAR_BIT - 1)) : U{0};
+
+    const auto key = [](T val, std::size_t pass) -> std::size_t {
+        return (static_cast<U>(static_cast<U>(val) ^ sign_bit) >> (pass * CHAR_BIT)) & 0xFF;
+    };
+
+    std::vector<T> buffer(vec.size());
+
+    for (std::size_t pass = 0; pass < num_passes; pass++) {
+        std::array<std::size_t, 256> counts{};
+        for (T val : vec) {
+            ++counts[key(val, pass)];
+        }
+
+        if (counts[key(vec.front(), pass)] == vec.size()) {
+            continue;
+        }
+
+        std::size_t total = 0;
+        for (auto& c : counts) {
+            auto old = c;
+            c = total;
+            total += old;
+        }
+
+        for (T val : vec) {
+            buffer[counts[key(val, pass)]++] = val;
+        }
+
+        vec.swap(buffer);
+    }
+}
+
+// Below this size, sorting on a single thread wins
+inline constexpr std::size_t parallel_sort_threshold = 1 << 15;
+
+// Calls fn(i) for each i in [0, n), each on its own thread (the last on the
+// calling thread), and rethrows the first exception thrown, if any
+template <typename Fn>
+void run_on_threads(std::size_t n, Fn& fn)
+{
+    std::vector<std::exception_ptr> errors(n);
+    const auto run = [&](std::size_t i) {
+        try {
+            fn(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(n - 1);
+    for (std::size_t i = 0; i + 1 < n; i++) {
+        threads.emplace_back(run, i);
+    }
+    run(n - 1);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+// Sorts one chunk per thread, then merges neighbouring runs in rounds, each
+// of which merges its pairs in parallel
+template <typename T, typename Cmp>
+void parallel_sort(std::vector<T>& vec, Cmp& cmp, std::size_t num_threads)
+{
+    const auto cmp_fn = invoke_cmp<Cmp>{cmp};
+    const std::size_t num_chunks =
+        detail::min(num_threads, vec.size() / (parallel_sort_threshold / 4));
+
+    if (num_chunks < 2) {
+        std::sort(vec.begin(), vec.end(), cmp_fn);
+        return;
+    }
+
+    std::vector<std::size_t> bounds(num_chunks + 1);
+    for (std::size_t i = 0; i <= num_chunks; i++) {
+        bounds[i] = vec.size() * i / num_chunks;
+    }
+    const auto at = [&vec](std::size_t pos) {
+        return vec.begin() + static_cast<std::ptrdiff_t>(pos);
+    };
+
+    auto sort_chunk = [&](std::size_t i) {
+        std::sort(at(bounds[i]), at(bounds[i + 1]), cmp_fn);
+    };
+    run_on_threads(num_chunks, sort_chunk);
+
+    for (std::size_t width = 1; width < num_chunks; width *= 2) {
+        const std::size_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+        auto merge_pair = [&](std::size_t m) {
+            const std::size_t first = m * 2 * width;
+            const std::size_t mid = first + width;
+            if (mid < num_chunks) {
+                const std::size_t last = detail::min(mid + width, num_chunks);
+                std::inplace_merge(at(bounds[first]), at(bounds[mid]),
+                                   at(bounds[last]), cmp_fn);
+            }
+        };
+        run_on_threads(num_merges, merge_pair);
+    }
+}
+
+} // namespace detail
+
+inline constexpr auto sorted = detail::sorted_op{};
+
+inline constexpr auto par_sorted = detail::par_sorted_op{};
+
+inline constexpr auto top_k = detail::top_k_op{};
+
+inline constexpr auto nth_element = detail::nth_element_op{};
+
+template <typename D>
+template <typename Cmp>
+auto flow_base<D>::sorted(Cmp cmp) &&
+{
+    static_assert(!is_infinite_flow<D>,
+                  "Cannot sort an infinite flow");
+    static_assert(std::is_invocable_r_v<bool, Cmp&, value_t<D> const&, value_t<D> const&>,
+                  "Incompatible comparator passed to sorted()");
+
+    using T = value_t<D>;
+
+    std::vector<T> vec;
+    if constexpr (is_sized_flow<D>) {
+        vec.reserve(static_cast<std::size_t>(derived().size()));
+    }
+    derived().for_each([&vec](auto&& item) { vec.push_back(FLOW_FWD(item)); });
+
+    if constexpr (detail::is_radix_sortable<T> &&
+                  (detail::is_ascending_cmp<Cmp, T> || detail::is_descending_cmp<Cmp, T>)) {
+        if (vec.size() >= detail::radix_sort_threshold) {
+            detail::radix_sort(vec);
+            if constexpr (detail::is_descending_cmp<Cmp, T>) {
+                std::reverse(vec.begin(), vec.end());
+            }
+            return vec;
+        }
+    }
+
+    std::sort(vec.begin(), vec.end(), detail::invoke_cmp<Cmp>{cmp});
+    return vec;
+}
+
+template <typename D>
+template <typename Cmp>
+auto flow_base<D>::par_sorted(Cmp cmp) &&
+{
+    static_assert(!is_infinite_flow<D>,
+                  "Cannot sort an infinite flow");
+    static_assert(std::is_invocable_r_v<bool, Cmp&, value_t<D> const&, value_t<D> const&>,
+                  "Incompatible comparator passed to par_sorted()");
+
+    using T = value_t<D>;
+
+    if constexpr (detail::is_radix_sortable<T> &&
+                  (detail::is_ascending_cmp<Cmp, T> || detail::is_descending_cmp<Cmp, T>)) {
+        return consume().sorted(std::move(cmp));
+    } else {
+        auto vec = consume().to_vector();
+        if (vec.size() < detail::parallel_sort_threshold) {
+            std::sort(vec.begin(), vec.end(), detail::invoke_cmp<Cmp>{cmp});
+        } else {
+            detail::parallel_sort(vec, cmp, detail::max(
+                std::size_t{std::thread::hardware_concurrency()}, std::size_t{1}));
+        }
+        return vec;
+    }
+}
+
+template <typename D>
+template <typename Cmp>
+auto flow_base<D>::top_k(dist_t k, Cmp cmp)
+{
+    static_assert(!is_infinite_flow<D>,
+                  "Cannot call top_k() on an infinite flow");
+    static_assert(std::is_invocable_r_v<bool, Cmp&, value_t<D> const&, value_t<D> const&>,
+                  "Incompatible comparator passed to top_k()");
+    assert(k >= 0 && "Cannot take a negative number of items!");
+
+    using T = value_t<D>;
+
+    std::vector<T> heap;
+    if (k == 0) {
+        return heap;
+    }
+
+    if constexpr (is_sized_flow<D>) {
+        heap.reserve(static_cast<std::size_t>(detail::min(k, derived().size())));
+    } else {
+        heap.reserve(static_cast<std::size_t>(k));
+    }
+
+    // The heap is ordered so that the "worst" of the items we have kept so
+    // far is at the front, ready to be evicted by a better one
+    const auto heap_cmp = detail::invoke_cmp<Cmp>{cmp};
+
+    derived().for_each([&heap, &heap_cmp, k](auto&& item) {
+        if (static_cast<dist_t>(heap.size()) < k) {
+            heap.push_back(FLOW_FWD(item));
+            std::push_heap(heap.begin(), heap.end(), heap_cmp);
+        } else if (heap_cmp(item, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), heap_cmp);
+            heap.back() = FLOW_FWD(item);
+            std::push_heap(heap.begin(), heap.end(), heap_cmp);
+        }
+    });
+
+    std::sort_heap(heap.begin(), heap.end(), heap_cmp);
+    return heap;
+}
+
+template <typename D>
+template <typename Cmp>
+auto flow_base<D>::nth_element(dist_t n, Cmp cmp)
+{
+    assert(n >= 0 && "nth_element() requires a non-negative index");
+
+    using return_t = maybe<value_t<D>>;
+
+    auto vec = derived().top_k(n + 1, std::move(cmp));
+    if (static_cast<dist_t>(vec.size()) <= n) {
+        return return_t{};
+    }
+    return return_t{std::move(vec.back())};
+}
+
+}
+
+#endif
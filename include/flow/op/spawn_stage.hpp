@@ -0,0 +1,142 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_SPAWN_STAGE_HPP_INCLUDED
+#define FLOW_OP_SPAWN_STAGE_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+#include <flow/source/channel.hpp>
+
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+template <typename Flow>
+struct spawn_stage_adaptor : flow_base<spawn_stage_adaptor<Flow>> {
+
+    using value_type = value_t<Flow>;
+
+    spawn_stage_adaptor(Flow&& flow, std::size_t buffer_size)
+        : state_(std::make_unique<state>(buffer_size)),
+          receiver_(state_->chan.receiver(batch_size(buffer_size)))
+    {
+        state_->producer = std::thread(
+            [st = state_.get(), flow = std::move(flow),
+             n = batch_size(buffer_size)]() mutable {
+                produce(*st, flow, n);
+                st->chan.close();
+            });
+    }
+
+    spawn_stage_adaptor(spawn_stage_adaptor&&) noexcept = default;
+    spawn_stage_adaptor& operator=(spawn_stage_adaptor&&) noexcept = default;
+
+    auto next() -> maybe<value_type>
+    {
+        if (auto m = receiver_.next()) {
+            return m;
+        }
+        if (state_->producer.joinable()) {
+            state_->producer.join();
+            if (state_->error) {
+                std::rethrow_exception(std::exchange(state_->error, nullptr));
+            }
+        }
+        return {};
+    }
+
+private:
+    struct state;
+
+    // Runs on the producer thread. Items are pushed in batches; if upstream
+    // throws, the partial batch is still delivered before the exception.
+    static void produce(state& st, Flow& flow, std::size_t batch_size)
+    {
+        std::vector<value_type> batch;
+        batch.reserve(batch_size);
+
+        const auto push = [&] {
+            const bool ok =
+                st.chan.push_batch(batch.begin(), batch.size()) == batch.size();
+            batch.clear();
+            return ok;
+        };
+
+        try {
+            while (auto m = flow.next()) {
+                batch.push_back(*std::move(m));
+                if (batch.size() == batch_size && !push()) {
+                    return;
+                }
+            }
+        } catch (...) {
+            st.error = std::current_exception();
+        }
+        push();
+    }
+
+    // Push and pull the buffer in batches, but keep them small enough that the
+    // producer is not starved of space
+    static auto batch_size(std::size_t buffer_size) -> std::size_t
+    {
+        return detail::max(detail::min(buffer_size / 4, std::size_t{64}),
+                           std::size_t{1});
+    }
+
+    struct state {
+        explicit state(std::size_t buffer_size) : chan(buffer_size) {}
+
+        // Closing the channel makes the producer's next push fail, so it
+        // stops pulling from upstream
+        ~state()
+        {
+            chan.close();
+            if (producer.joinable()) {
+                producer.join();
+            }
+        }
+
+        spsc_channel<value_type> chan;
+        std::exception_ptr error;
+        std::thread producer;
+    };
+
+    // The channel must stay put while the producer thread refers to it
+    std::unique_ptr<state> state_;
+    channel_receiver<spsc_channel<value_type>> receiver_;
+};
+
+struct spawn_stage_fn {
+    template <typename Flowable>
+    auto operator()(Flowable&& flowable, std::size_t buffer_size = 1024) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::spawn_stage() must be a Flowable type");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable))).spawn_stage(buffer_size);
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto spawn_stage = detail::spawn_stage_fn{};
+
+template <typename D>
+auto flow_base<D>::spawn_stage(std::size_t buffer_size) &&
+{
+    static_assert(std::is_move_constructible_v<value_t<D>>,
+                  "spawn_stage() requires a flow whose value type is movable");
+    assert(buffer_size > 0);
+    return detail::spawn_stage_adaptor<D>(consume(), buffer_size);
+}
+
+}
+
+#endif
@@ -15,6 +15,8 @@ namespace detail {
 template <typename Flow>
 struct take_adaptor : flow_base<take_adaptor<Flow>> {
 
+    static constexpr bool is_random_access = is_random_access_flow<Flow>;
+
     constexpr take_adaptor(Flow&& flow, dist_t count)
         : flow_(std::move(flow)),
           count_(count)
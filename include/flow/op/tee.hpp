@@ -0,0 +1,182 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_TEE_HPP_INCLUDED
+#define FLOW_OP_TEE_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+// The state shared by all readers of a tee. Items are identified by their
+// absolute index in the upstream flow; the buffer holds the items from
+// `base` onwards.
+template <typename Flow>
+struct tee_state {
+
+    using value_type = value_t<Flow>;
+
+    static constexpr std::size_t detached = std::numeric_limits<std::size_t>::max();
+
+    tee_state(Flow&& flow, std::size_t num_readers, tee_policy policy,
+              std::size_t max_buffered)
+        : flow_(std::move(flow)),
+          pos_(num_readers, 0),
+          policy_(policy),
+          max_buffered_(max_buffered)
+    {}
+
+    auto next(std::size_t reader) -> maybe<value_type>
+    {
+        std::unique_lock lock(mutex_);
+        auto& pos = pos_[reader];
+
+        while (pos == base_ + buf_.size()) {
+            if (done_) {
+                return {};
+            }
+            if (policy_ == tee_policy::spill || buf_.size() < max_buffered_) {
+                auto m = flow_.next();
+                if (!m) {
+                    done_ = true;
+                } else {
+                    buf_.push_back(*std::move(m));
+                }
+                cv_.notify_all();
+            } else {
+                cv_.wait(lock);
+            }
+        }
+
+        const std::size_t idx = pos++ - base_;
+        if (idx == 0 && slowest() > base_) {
+            // We were the last reader of the front item, so we can have it
+            auto val = std::move(buf_.front());
+            pop_front();
+            return {std::move(val)};
+        }
+        return {buf_[idx]};
+    }
+
+    void detach(std::size_t reader)
+    {
+        std::lock_guard lock(mutex_);
+        pos_[reader] = detached;
+        const std::size_t min = slowest();
+        while (!buf_.empty() && base_ < min) {
+            pop_front();
+        }
+    }
+
+private:
+    auto slowest() const -> std::size_t
+    {
+        std::size_t min = detached;
+        for (auto p : pos_) {
+            min = detail::min(min, p);
+        }
+        return min;
+    }
+
+    void pop_front()
+    {
+        buf_.pop_front();
+        ++base_;
+        cv_.notify_all();
+    }
+
+    Flow flow_;
+    std::deque<value_type> buf_;
+    std::size_t base_ = 0;
+    std::vector<std::size_t> pos_;
+    tee_policy policy_;
+    std::size_t max_buffered_;
+    bool done_ = false;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+template <typename Flow>
+struct tee_adaptor : flow_base<tee_adaptor<Flow>> {
+
+    tee_adaptor(std::shared_ptr<tee_state<Flow>> state, std::size_t reader)
+        : state_(std::move(state)), reader_(reader)
+    {}
+
+    tee_adaptor(tee_adaptor&&) noexcept = default;
+
+    tee_adaptor& operator=(tee_adaptor&& other) noexcept
+    {
+        if (this != std::addressof(other)) {
+            release();
+            state_ = std::move(other.state_);
+            reader_ = other.reader_;
+        }
+        return *this;
+    }
+
+    ~tee_adaptor() { release(); }
+
+    auto next() -> maybe<value_t<Flow>>
+    {
+        return state_->next(reader_);
+    }
+
+private:
+    void release()
+    {
+        if (state_) {
+            state_->detach(reader_);
+        }
+    }
+
+    std::shared_ptr<tee_state<Flow>> state_;
+    std::size_t reader_;
+};
+
+struct tee_fn {
+    template <typename Flowable>
+    auto operator()(Flowable&& flowable, std::size_t n,
+                    tee_policy policy = tee_policy::spill,
+                    std::size_t max_buffered = 1024) const
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to flow::tee() must be a Flowable type");
+        return FLOW_COPY(flow::from(FLOW_FWD(flowable))).tee(n, policy, max_buffered);
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto tee = detail::tee_fn{};
+
+template <typename D>
+auto flow_base<D>::tee(std::size_t n, tee_policy policy, std::size_t max_buffered) &&
+{
+    static_assert(std::is_copy_constructible_v<value_t<D>>,
+                  "tee() requires a flow whose value type is copyable");
+    assert(max_buffered > 0);
+
+    auto state = std::make_shared<detail::tee_state<D>>(consume(), n, policy, max_buffered);
+    std::vector<detail::tee_adaptor<D>> readers;
+    readers.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        readers.emplace_back(state, i);
+    }
+    return readers;
+}
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #define FLOW_OP_TO_HPP_INCLUDED
 
 #include <flow/core/flow_base.hpp>
+#include <flow/op/to_range.hpp>
 
 namespace flow {
 
@@ -71,7 +72,7 @@ constexpr auto flow_base<D>::to() && -> C
     if constexpr (std::is_constructible_v<C, D&&>) {
         return C(consume());
     } else {
-        auto rng = consume().to_range();
+        auto rng = detail::make_single_pass_range(consume());
         static_assert(std::is_constructible_v<C, decltype(rng.begin()),
                                               decltype(rng.end())>);
         return C(rng.begin(), rng.end());
@@ -85,7 +86,7 @@ constexpr auto flow_base<D>::to() &&
     if constexpr (detail::is_ctad_constructible_v<void, C, D&&>) {
         return C(consume());
     } else {
-        auto rng = consume().to_range();
+        auto rng = detail::make_single_pass_range(consume());
         static_assert(detail::is_ctad_constructible_v<void, C,
                       decltype(rng.begin()), decltype(rng.end())>);
         return C(rng.begin(), rng.end());
@@ -71,7 +71,7 @@ public:
         : flow_(std::move(flow)), item_(flow_.next())
     {}
 
-    constexpr auto begin() { return iterator{*this}; }
+    constexpr auto begin() { return item_ ? iterator{*this} : iterator{}; }
     constexpr auto end() { return iterator{}; }
 
 private:
@@ -85,6 +85,278 @@ private:
     maybe<item_t<F>> item_;
 };
 
+// Iterators which may be dereferenced more than once must not move from the
+// underlying item, so rvalue items are returned by value
+template <typename F>
+using range_reference_t =
+    std::conditional_t<std::is_lvalue_reference_v<item_t<F>>, item_t<F>, value_t<F>>;
+
+// Multipass flows get forward iterators, each of which owns a subflow
+template <typename F>
+struct multipass_flow_range {
+private:
+    using subflow_type = subflow_t<F>;
+
+    struct iterator {
+        using value_type = value_t<F>;
+        using reference = range_reference_t<F>;
+        using difference_type = dist_t;
+        using pointer = value_type*;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        constexpr explicit iterator(subflow_type&& sub)
+            : sub_(std::move(sub))
+        {
+            item_ = sub_->next();
+        }
+
+        // Subflows are generally not assignable (they may hold lambdas), so
+        // we reconstruct rather than assign
+        constexpr iterator(iterator const&) = default;
+        constexpr iterator(iterator&&) = default;
+
+        constexpr iterator& operator=(iterator const& other)
+        {
+            if (this != std::addressof(other)) {
+                sub_.reset();
+                item_.reset();
+                sub_ = other.sub_;
+                item_ = other.item_;
+                pos_ = other.pos_;
+            }
+            return *this;
+        }
+
+        constexpr iterator& operator=(iterator&& other)
+        {
+            sub_.reset();
+            item_.reset();
+            sub_ = std::move(other.sub_);
+            item_ = std::move(other.item_);
+            pos_ = other.pos_;
+            return *this;
+        }
+
+        constexpr iterator& operator++()
+        {
+            item_.reset();
+            item_ = sub_->next();
+            ++pos_;
+            return *this;
+        }
+
+        constexpr iterator operator++(int)
+        {
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        constexpr reference operator*() const { return *item_; }
+
+        constexpr pointer operator->() const
+        {
+            static_assert(std::is_lvalue_reference_v<reference>,
+                          "operator-> requires a flow whose items are lvalue references");
+            return std::addressof(**this);
+        }
+
+        friend constexpr bool operator==(const iterator& lhs,
+                                         const iterator& rhs)
+        {
+            return lhs.item_.has_value() == rhs.item_.has_value() &&
+                   (!lhs.item_ || lhs.pos_ == rhs.pos_);
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs,
+                                         const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        maybe<subflow_type> sub_;
+        maybe<item_t<F>> item_;
+        dist_t pos_ = 0;
+    };
+
+public:
+    constexpr explicit multipass_flow_range(F&& flow)
+        : flow_(std::move(flow))
+    {}
+
+    constexpr auto begin() { return iterator{flow_.subflow()}; }
+    constexpr auto end() { return iterator{}; }
+
+    template <typename G = F>
+    constexpr auto size() const -> std::enable_if_t<is_sized_flow<G>, dist_t>
+    {
+        return flow_.size();
+    }
+
+private:
+    F flow_;
+};
+
+// Random-access iterators hold a position rather than an item. Each
+// dereference takes a fresh subflow and jumps to the position with advance(),
+// which is O(1) for random-access flows.
+template <typename F>
+struct ra_flow_range {
+private:
+    struct iterator {
+        using value_type = value_t<F>;
+        using reference = range_reference_t<F>;
+        using difference_type = dist_t;
+        using pointer = value_type*;
+        using iterator_category = std::random_access_iterator_tag;
+
+        constexpr iterator() = default;
+
+        constexpr iterator(F& flow, dist_t idx)
+            : flow_(std::addressof(flow)), idx_(idx)
+        {}
+
+        constexpr reference operator*() const
+        {
+            return *flow_->subflow().advance(idx_ + 1);
+        }
+
+        constexpr pointer operator->() const
+        {
+            static_assert(std::is_lvalue_reference_v<reference>,
+                          "operator-> requires a flow whose items are lvalue references");
+            return std::addressof(**this);
+        }
+
+        constexpr reference operator[](dist_t n) const
+        {
+            return *(*this + n);
+        }
+
+        constexpr iterator& operator++() { ++idx_; return *this; }
+        constexpr iterator& operator--() { --idx_; return *this; }
+
+        constexpr iterator operator++(int)
+        {
+            auto temp = *this;
+            ++idx_;
+            return temp;
+        }
+
+        constexpr iterator operator--(int)
+        {
+            auto temp = *this;
+            --idx_;
+            return temp;
+        }
+
+        constexpr iterator& operator+=(dist_t n) { idx_ += n; return *this; }
+        constexpr iterator& operator-=(dist_t n) { idx_ -= n; return *this; }
+
+        friend constexpr iterator operator+(iterator it, dist_t n)
+        {
+            return it += n;
+        }
+
+        friend constexpr iterator operator+(dist_t n, iterator it)
+        {
+            return it += n;
+        }
+
+        friend constexpr iterator operator-(iterator it, dist_t n)
+        {
+            return it -= n;
+        }
+
+        friend constexpr dist_t operator-(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.idx_ - rhs.idx_;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.idx_ == rhs.idx_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.idx_ != rhs.idx_;
+        }
+
+        friend constexpr bool operator<(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.idx_ < rhs.idx_;
+        }
+
+        friend constexpr bool operator>(const iterator& lhs, const iterator& rhs)
+        {
+            return rhs < lhs;
+        }
+
+        friend constexpr bool operator<=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(rhs < lhs);
+        }
+
+        friend constexpr bool operator>=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs < rhs);
+        }
+
+    private:
+        F* flow_ = nullptr;
+        dist_t idx_ = 0;
+    };
+
+public:
+    constexpr explicit ra_flow_range(F&& flow)
+        : flow_(std::move(flow))
+    {}
+
+    constexpr auto begin() { return iterator{flow_, 0}; }
+    constexpr auto end() { return iterator{flow_, flow_.size()}; }
+
+    constexpr auto size() const -> dist_t { return flow_.size(); }
+
+private:
+    F flow_;
+};
+
+template <typename F, typename = void>
+inline constexpr bool has_copyable_subflow = false;
+
+template <typename F>
+inline constexpr bool has_copyable_subflow<F, std::enable_if_t<is_multipass_flow<F>>> =
+    std::is_copy_constructible_v<subflow_t<F>>;
+
+template <typename F>
+constexpr auto make_flow_range(F flow)
+{
+    if constexpr (is_random_access_flow<F>) {
+        return ra_flow_range<F>{std::move(flow)};
+    } else if constexpr (has_copyable_subflow<F>) {
+        return multipass_flow_range<F>{std::move(flow)};
+    } else {
+        return flow_range<F>{std::move(flow)};
+    }
+}
+
+// For building containers we want each item to be evaluated exactly once.
+// Random-access ranges manage this while allowing the container to allocate
+// up-front; forward ranges would be traversed twice.
+template <typename F>
+constexpr auto make_single_pass_range(F flow)
+{
+    if constexpr (is_random_access_flow<F>) {
+        return ra_flow_range<F>{std::move(flow)};
+    } else {
+        return flow_range<F>{std::move(flow)};
+    }
+}
+
 }
 
 inline constexpr auto to_range = [](auto&& flowable)
@@ -97,7 +369,7 @@ inline constexpr auto to_range = [](auto&& flowable)
 template <typename D>
 constexpr auto flow_base<D>::to_range() &&
 {
-    return detail::flow_range<D>{consume()};
+    return detail::make_flow_range(consume());
 }
 
 }
@@ -0,0 +1,355 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_OP_WRITE_BUFFERED_HPP_INCLUDED
+#define FLOW_OP_WRITE_BUFFERED_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+#ifdef FLOW_HAVE_POSIX_IO
+#include <cerrno>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace flow {
+
+namespace detail {
+
+inline constexpr std::size_t write_buffer_size = 64 * 1024;
+
+// Enough for any arithmetic type formatted with to_chars(), including the
+// shortest round-trip representation of a long double
+inline constexpr std::size_t max_formatted_size = 128;
+
+struct file_sink {
+    std::FILE* file;
+
+    auto write(const char* data, std::size_t len) const -> bool
+    {
+        return std::fwrite(data, 1, len, file) == len;
+    }
+};
+
+struct streambuf_sink {
+    std::streambuf* buf;
+
+    auto write(const char* data, std::size_t len) const -> bool
+    {
+        return buf->sputn(data, static_cast<std::streamsize>(len)) ==
+               static_cast<std::streamsize>(len);
+    }
+};
+
+#ifdef FLOW_HAVE_POSIX_IO
+struct fd_sink {
+    int fd;
+
+    auto write(const char* data, std::size_t len) const -> bool
+    {
+        while (len > 0) {
+            const auto n = ::write(fd, data, len);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += n;
+            len -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+};
+#endif
+
+template <typename T>
+inline constexpr bool is_narrow_char =
+    std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+    std::is_same_v<T, unsigned char>;
+
+template <typename Sink>
+struct write_buffer {
+
+    explicit write_buffer(Sink sink)
+        : sink_(sink),
+          buf_(new char[write_buffer_size])
+    {}
+
+    template <typename T>
+    void put(T const& val)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            // As std::ostream does without std::boolalpha
+            put_char(val ? '1' : '0');
+        } else if constexpr (is_narrow_char<T>) {
+            put_char(static_cast<char>(val));
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            if (write_buffer_size - len_ < max_formatted_size) {
+                flush();
+            }
+            char* const first = buf_.get() + len_;
+            const auto res = std::to_chars(first, first + max_formatted_size, val);
+            len_ += static_cast<std::size_t>(res.ptr - first);
+        } else if constexpr (std::is_convertible_v<T const&, std::string_view>) {
+            put_string(std::string_view(val));
+        } else {
+            static_assert(std::is_arithmetic_v<T>,
+                "write_buffered() requires items which are arithmetic types "
+                "or are convertible to std::string_view");
+        }
+    }
+
+    // Writes out any buffered output, returning false if anything written
+    // so far has failed
+    auto flush() -> bool
+    {
+        if (len_ > 0) {
+            ok_ = ok_ && sink_.write(buf_.get(), len_);
+            len_ = 0;
+        }
+        return ok_;
+    }
+
+private:
+    void put_char(char c)
+    {
+        if (len_ == write_buffer_size) {
+            flush();
+        }
+        buf_[len_++] = c;
+    }
+
+    void put_string(std::string_view str)
+    {
+        if (str.size() > write_buffer_size - len_) {
+            flush();
+            // Large strings bypass the buffer entirely
+            if (str.size() > write_buffer_size / 2) {
+                ok_ = ok_ && sink_.write(str.data(), str.size());
+                return;
+            }
+        }
+        std::memcpy(buf_.get() + len_, str.data(), str.size());
+        len_ += str.size();
+    }
+
+    Sink sink_;
+    std::unique_ptr<char[]> buf_;
+    std::size_t len_ = 0;
+    bool ok_ = true;
+};
+
+template <typename Flow, typename Sink, typename Sep>
+auto write_buffered_impl(Flow&& flow, Sink sink, Sep const& sep) -> bool
+{
+    write_buffer<Sink> buf(sink);
+    flow.for_each([&buf, &sep, first = true](auto const& item) mutable {
+        if (first) {
+            first = false;
+        } else {
+            buf.put(sep);
+        }
+        buf.put(item);
+    });
+    return buf.flush();
+}
+
+#ifdef FLOW_HAVE_POSIX_IO
+
+// Comfortably below IOV_MAX on every platform we know of
+inline constexpr int writev_batch_size = 512;
+
+// Writes all of the given buffers, resuming after partial writes
+inline auto writev_all(int fd, ::iovec* iov, int count) -> bool
+{
+    while (count > 0) {
+        const auto res = ::writev(fd, iov, count);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        auto n = static_cast<std::size_t>(res);
+        while (count > 0 && n >= iov->iov_len) {
+            n -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+            iov->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+// Items which can be passed to writev(). Only lvalue references are queued
+// without copying: a view returned by value may point into a buffer which
+// the source refills on the next call to next(), so it is copied into a
+// staging buffer first.
+template <typename I>
+inline constexpr bool is_stable_chunk =
+    std::is_convertible_v<I, std::string_view> &&
+    (std::is_lvalue_reference_v<I> ||
+     std::is_same_v<remove_cvref_t<I>, std::string_view> ||
+     std::is_same_v<remove_cvref_t<I>, const char*>);
+
+#endif // FLOW_HAVE_POSIX_IO
+
+struct write_buffered_fn {
+    template <typename Flowable, typename Dest, typename Sep = const char*>
+    auto operator()(Flowable&& flowable, Dest&& dest, Sep sep = ", ") const -> bool
+    {
+        static_assert(is_flowable<Flowable>,
+                      "First argument to flow::write_buffered() must be Flowable");
+        return flow::from(FLOW_FWD(flowable)).write_buffered(FLOW_FWD(dest), sep);
+    }
+};
+
+} // namespace detail
+
+inline constexpr auto write_buffered = detail::write_buffered_fn{};
+
+template <typename D>
+template <typename Sep>
+auto flow_base<D>::write_buffered(std::FILE* file, Sep sep) -> bool
+{
+    return detail::write_buffered_impl(consume(), detail::file_sink{file}, sep);
+}
+
+template <typename D>
+template <typename Sep>
+auto flow_base<D>::write_buffered(std::streambuf& buf, Sep sep) -> bool
+{
+    return detail::write_buffered_impl(consume(), detail::streambuf_sink{&buf}, sep);
+}
+
+#ifdef FLOW_HAVE_POSIX_IO
+
+template <typename D>
+template <typename Sep>
+auto flow_base<D>::write_buffered(int fd, Sep sep) -> bool
+{
+    return detail::write_buffered_impl(consume(), detail::fd_sink{fd}, sep);
+}
+
+namespace detail {
+
+struct writev_to_fn {
+    template <typename Flowable, typename Sep = const char*>
+    auto operator()(Flowable&& flowable, int fd, Sep sep = ", ") const -> bool
+    {
+        static_assert(is_flowable<Flowable>,
+                      "First argument to flow::writev_to() must be Flowable");
+        return flow::from(FLOW_FWD(flowable)).writev_to(fd, sep);
+    }
+};
+
+}
+
+inline constexpr auto writev_to = detail::writev_to_fn{};
+
+template <typename D>
+template <typename Sep>
+auto flow_base<D>::writev_to(int fd, Sep sep) -> bool
+{
+    static_assert(detail::is_stable_chunk<item_t<D>>,
+                  "writev_to() requires a flow whose items are lvalue references "
+                  "to strings, or std::string_views");
+
+    const std::string sep_str = [&sep] {
+        if constexpr (std::is_same_v<Sep, char>) {
+            return std::string(1, sep);
+        } else {
+            return std::string(std::string_view(sep));
+        }
+    }();
+
+    ::iovec iov[detail::writev_batch_size];
+    int count = 0;
+    bool ok = true;
+
+    auto flush = [&] {
+        ok = ok && detail::writev_all(fd, iov, count);
+        count = 0;
+    };
+
+    auto push = [&](std::string_view str) {
+        if (str.empty()) {
+            return;
+        }
+        if (count == detail::writev_batch_size) {
+            flush();
+        }
+        iov[count].iov_base = const_cast<char*>(str.data());
+        iov[count].iov_len = str.size();
+        ++count;
+    };
+
+    // Items which do not outlive the next call to next() are copied into
+    // this buffer. Consecutive copies are coalesced into a single iovec, and
+    // everything queued is written out once the buffer is full.
+    std::unique_ptr<char[]> staging;
+    std::size_t staged = 0;
+
+    auto stage = [&](std::string_view str) {
+        if (str.size() > detail::write_buffer_size - staged) {
+            flush();
+            staged = 0;
+            // Too big to stage, so write it straight away
+            if (str.size() > detail::write_buffer_size) {
+                push(str);
+                flush();
+                return;
+            }
+        }
+        char* dest = staging.get() + staged;
+        std::memcpy(dest, str.data(), str.size());
+        staged += str.size();
+        if (count > 0 && static_cast<char*>(iov[count - 1].iov_base) +
+                                 iov[count - 1].iov_len == dest) {
+            iov[count - 1].iov_len += str.size();
+        } else {
+            push(std::string_view(dest, str.size()));
+        }
+    };
+
+    if constexpr (!std::is_lvalue_reference_v<item_t<D>>) {
+        staging.reset(new char[detail::write_buffer_size]);
+    }
+
+    consume().for_each([&, first = true](auto&& item) mutable {
+        if constexpr (std::is_lvalue_reference_v<item_t<D>>) {
+            if (!first) {
+                push(sep_str);
+            }
+            push(std::string_view(item));
+        } else {
+            if (!first) {
+                stage(sep_str);
+            }
+            stage(std::string_view(item));
+        }
+        first = false;
+    });
+
+    return ok && detail::writev_all(fd, iov, count);
+}
+
+#endif // FLOW_HAVE_POSIX_IO
+
+}
+
+#endif
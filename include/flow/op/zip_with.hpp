@@ -8,6 +8,7 @@
 
 #include <flow/core/flow_base.hpp>
 #include <flow/source/from.hpp>
+#include <flow/source/iota.hpp>
 
 #include <limits>
 
@@ -33,6 +34,58 @@ constexpr auto size_or_infinity(const F& flow) -> dist_t
     }
 }
 
+template <typename F>
+inline constexpr bool is_integral_iota_flow = false;
+
+template <typename V>
+inline constexpr bool is_integral_iota_flow<iota_flow<V>> = std::is_integral_v<V>;
+
+// Flows whose items can be computed from an offset alone, so that zipping
+// them needs just one loop counter. Unbounded integer iotas are included
+// for the sake of enumerate().
+template <typename... Flows>
+inline constexpr bool is_indexable_zip =
+    is_sized_zip<Flows...> &&
+    ((is_contiguous_flow<Flows> || is_integral_iota_flow<Flows>) && ...);
+
+// Returns a callable giving the item at offset i from the front of an
+// indexable flow, without advancing it
+template <typename F>
+constexpr auto zip_indexer(F& flow)
+{
+    if constexpr (is_contiguous_flow<F>) {
+        auto ptr = flow.data();
+        return [ptr](dist_t i) -> decltype(auto) { return ptr[i]; };
+    } else {
+        auto start = *flow.subflow().next();
+        return [start](dist_t i) { return static_cast<decltype(start)>(start + i); };
+    }
+}
+
+// A try_fold() for zips of indexable flows with no per-flow end checks in
+// the loop, which compilers are able to vectorise. The flows are advanced
+// past the items used once the loop has finished.
+template <typename Item, typename Func, typename Fn, typename Init, typename... Flows>
+constexpr auto zip_indexed_try_fold(Func& func, Fn& fn, Init init, dist_t size,
+                                    Flows&... flows) -> Init
+{
+    dist_t i = 0;
+    [&](auto... index) {
+        while (i < size) {
+            init = invoke(fn, std::move(init), maybe<Item>(invoke(func, index(i)...)));
+            ++i;
+            if (!static_cast<bool>(init)) {
+                break;
+            }
+        }
+    }(zip_indexer(flows)...);
+
+    if (i > 0) {
+        ((void) flows.advance(i), ...);
+    }
+    return init;
+}
+
 template <typename Func, typename... Flows>
 struct zip_with_adaptor : flow_base<zip_with_adaptor<Func, Flows...>> {
 
@@ -65,9 +118,24 @@ struct zip_with_adaptor : flow_base<zip_with_adaptor<Func, Flows...>> {
         return {};
     }
 
+    template <typename Fn, typename Init>
+    constexpr auto try_fold(Fn fn, Init init) -> Init
+    {
+        if constexpr (is_indexable_zip<Flows...>) {
+            return std::apply([&](auto&... flows) {
+                return zip_indexed_try_fold<item_type>(func_, fn, std::move(init), size(),
+                                                       flows...);
+            }, flows_);
+        } else {
+            return flow_base<zip_with_adaptor>::try_fold(std::move(fn), std::move(init));
+        }
+    }
+
+    // The return type is deduced so that subflow_t<Flows> is not named
+    // unless every flow is multipass
     template <bool B = (is_multipass_flow<Flows> && ...),
               typename = std::enable_if_t<B>>
-    constexpr auto subflow() & -> zip_with_adaptor<function_ref<Func>, subflow_t<Flows>...>
+    constexpr auto subflow() &
     {
         return std::apply([&func_ = func_](auto&... args) {
             return zip_with_adaptor<function_ref<Func>, subflow_t<Flows>...>(func_, args.subflow()...);
@@ -115,6 +183,16 @@ struct zip_with_adaptor<Func, F1, F2> : flow_base<zip_with_adaptor<Func, F1, F2>
         return {};
     }
 
+    template <typename Fn, typename Init>
+    constexpr auto try_fold(Fn fn, Init init) -> Init
+    {
+        if constexpr (is_indexable_zip<F1, F2>) {
+            return zip_indexed_try_fold<item_type>(func_, fn, std::move(init), size(), f1_, f2_);
+        } else {
+            return flow_base<zip_with_adaptor>::try_fold(std::move(fn), std::move(init));
+        }
+    }
+
     template <typename S1 = F1, typename S2 = F2>
     constexpr auto subflow() & -> zip_with_adaptor<function_ref<Func>, subflow_t<S1>, subflow_t<S2>>
     {
@@ -0,0 +1,389 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_SOURCE_ASYNC_FLOW_HPP_INCLUDED
+#define FLOW_SOURCE_ASYNC_FLOW_HPP_INCLUDED
+
+#include <flow/core/macros.hpp>
+
+#ifdef FLOW_HAVE_COROUTINES
+
+#include <flow/core/flow_base.hpp>
+#include <flow/source/async.hpp>
+
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace flow {
+
+template <typename T>
+struct async_flow;
+
+template <typename R>
+struct async_task;
+
+namespace detail {
+
+// Suspends the current coroutine and resumes `next` in its place, without
+// growing the stack
+struct transfer_awaiter {
+    coro_ns::coroutine_handle<> next;
+
+    bool await_ready() const noexcept { return false; }
+
+    auto await_suspend(coro_ns::coroutine_handle<>) noexcept
+        -> coro_ns::coroutine_handle<>
+    {
+        return next ? next : coro_ns::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+template <typename Handle>
+void destroy_handle(Handle& handle)
+{
+    if (handle) {
+        handle.destroy();
+        handle = nullptr;
+    }
+}
+
+template <typename T, typename Func>
+auto async_map(async_flow<T> src, Func func)
+    -> async_flow<remove_cvref_t<std::invoke_result_t<Func&, T&&>>>;
+
+template <typename T, typename Pred>
+auto async_filter(async_flow<T> src, Pred pred) -> async_flow<T>;
+
+template <typename T>
+auto async_take(async_flow<T> src, dist_t count) -> async_flow<T>;
+
+template <typename T>
+auto async_chunk(async_flow<T> src, dist_t size) -> async_flow<std::vector<T>>;
+
+template <typename T, typename Func, typename Init>
+auto async_fold(async_flow<T> src, Func func, Init init) -> async_task<Init>;
+
+template <typename T, typename Func>
+auto async_for_each(async_flow<T> src, Func func) -> async_task<Func>;
+
+} // namespace detail
+
+/// An awaitable flow, produced by a coroutine which may `co_await` (for
+/// example, for I/O to complete) between `co_yield`s.
+///
+/// Consumers obtain each item with `co_await flow.next()`, which resumes
+/// the producing coroutine and suspends the consumer until the producer
+/// yields an item or finishes, in which case the result is an empty
+/// `maybe`. Control passes between the two by symmetric transfer, so long
+/// pipelines do not grow the stack.
+///
+/// The library does not include a scheduler: whatever resumes a suspended
+/// producer (typically an event loop, once a file descriptor is ready)
+/// drives the whole pipeline, and many such pipelines may be multiplexed on
+/// a single thread.
+///
+/// An exception escaping the producer is rethrown from `co_await next()`.
+template <typename T>
+struct [[nodiscard]] async_flow {
+
+    static_assert(!std::is_reference_v<T>,
+                  "The item type of an async_flow must not be a reference");
+
+    struct promise_type;
+
+    using handle_type = detail::coro_ns::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        maybe<T> value;
+        std::exception_ptr error;
+        detail::coro_ns::coroutine_handle<> consumer;
+
+        auto get_return_object() { return async_flow{handle_type::from_promise(*this)}; }
+
+        auto initial_suspend() noexcept { return detail::coro_ns::suspend_always{}; }
+
+        auto final_suspend() noexcept { return detail::transfer_awaiter{consumer}; }
+
+        auto yield_value(T val)
+        {
+            value = maybe<T>(std::move(val));
+            return detail::transfer_awaiter{consumer};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    struct next_awaiter {
+        handle_type coro;
+
+        bool await_ready() const noexcept { return !coro || coro.done(); }
+
+        auto await_suspend(detail::coro_ns::coroutine_handle<> consumer) noexcept
+            -> detail::coro_ns::coroutine_handle<>
+        {
+            coro.promise().consumer = consumer;
+            return coro;
+        }
+
+        auto await_resume() -> maybe<T>
+        {
+            if (!coro) {
+                return {};
+            }
+            auto& p = coro.promise();
+            if (p.error) {
+                std::rethrow_exception(std::exchange(p.error, nullptr));
+            }
+            auto val = std::move(p.value);
+            p.value.reset();
+            return val;
+        }
+    };
+
+    async_flow(async_flow&& other) noexcept
+        : coro_(std::exchange(other.coro_, nullptr))
+    {}
+
+    async_flow& operator=(async_flow&& other) noexcept
+    {
+        std::swap(coro_, other.coro_);
+        return *this;
+    }
+
+    ~async_flow() { detail::destroy_handle(coro_); }
+
+    /// Returns an awaitable whose result is the next item, or an empty
+    /// `maybe` once the flow is exhausted
+    auto next() -> next_awaiter { return next_awaiter{coro_}; }
+
+    /// Returns a new async flow whose items are `func(item)`
+    template <typename Func>
+    auto map(Func func) &&
+    {
+        static_assert(std::is_invocable_v<Func&, T&&>,
+                      "Incompatible callable passed to async_flow::map()");
+        return detail::async_map(std::move(*this), std::move(func));
+    }
+
+    /// Returns a new async flow yielding those items for which `pred(item)`
+    /// is true
+    template <typename Pred>
+    auto filter(Pred pred) && -> async_flow
+    {
+        static_assert(std::is_invocable_r_v<bool, Pred&, T const&>,
+                      "Incompatible predicate passed to async_flow::filter()");
+        return detail::async_filter(std::move(*this), std::move(pred));
+    }
+
+    /// Returns a new async flow yielding at most `count` items. The
+    /// producer is not resumed again once they have been received.
+    auto take(dist_t count) && -> async_flow
+    {
+        assert(count >= 0);
+        return detail::async_take(std::move(*this), count);
+    }
+
+    /// Returns a new async flow whose items are vectors of `size` items.
+    /// The last chunk may be smaller.
+    auto chunk(dist_t size) && -> async_flow<std::vector<T>>
+    {
+        assert(size > 0);
+        return detail::async_chunk(std::move(*this), size);
+    }
+
+    /// Returns a task which folds the items with `func`, starting from `init`
+    template <typename Func, typename Init>
+    auto fold(Func func, Init init) && -> async_task<Init>
+    {
+        static_assert(std::is_invocable_r_v<Init, Func&, Init&&, T&&>,
+                      "Incompatible callable passed to async_flow::fold()");
+        return detail::async_fold(std::move(*this), std::move(func), std::move(init));
+    }
+
+    /// Returns a task which calls `func` with each item, resulting in the
+    /// function object
+    template <typename Func>
+    auto for_each(Func func) && -> async_task<Func>
+    {
+        static_assert(std::is_invocable_v<Func&, T&&>,
+                      "Incompatible callable passed to async_flow::for_each()");
+        return detail::async_for_each(std::move(*this), std::move(func));
+    }
+
+    /// Returns a task which collects the items into a `std::vector`
+    auto to_vector() && -> async_task<std::vector<T>>
+    {
+        return std::move(*this).fold([](std::vector<T> vec, T&& item) {
+            vec.push_back(std::move(item));
+            return vec;
+        }, std::vector<T>{});
+    }
+
+private:
+    explicit async_flow(handle_type handle) : coro_(handle) {}
+
+    handle_type coro_;
+};
+
+/// A lazily-started coroutine producing a single value of type `R`.
+///
+/// Inside another coroutine, `co_await task` runs the task and produces its
+/// result. Elsewhere, `start()` runs the task until it first suspends; once
+/// `done()` (for example, after the event loop which resumes it has run),
+/// `result()` returns the value or rethrows the task's exception.
+template <typename R>
+struct [[nodiscard]] async_task {
+
+    struct promise_type;
+
+    using handle_type = detail::coro_ns::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        // Not a maybe, as R need not be assignable (e.g. a lambda)
+        std::optional<R> value;
+        std::exception_ptr error;
+        detail::coro_ns::coroutine_handle<> continuation;
+
+        auto get_return_object() { return async_task{handle_type::from_promise(*this)}; }
+
+        auto initial_suspend() noexcept { return detail::coro_ns::suspend_always{}; }
+
+        auto final_suspend() noexcept { return detail::transfer_awaiter{continuation}; }
+
+        void return_value(R val) { value.emplace(std::move(val)); }
+
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    async_task(async_task&& other) noexcept
+        : coro_(std::exchange(other.coro_, nullptr))
+    {}
+
+    async_task& operator=(async_task&& other) noexcept
+    {
+        std::swap(coro_, other.coro_);
+        return *this;
+    }
+
+    ~async_task() { detail::destroy_handle(coro_); }
+
+    void start() { coro_.resume(); }
+
+    [[nodiscard]] auto done() const -> bool { return coro_.done(); }
+
+    auto result() -> R
+    {
+        assert(done());
+        auto& p = coro_.promise();
+        if (p.error) {
+            std::rethrow_exception(std::exchange(p.error, nullptr));
+        }
+        return *std::move(p.value);
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct awaiter {
+            async_task& task;
+
+            bool await_ready() const noexcept { return false; }
+
+            auto await_suspend(detail::coro_ns::coroutine_handle<> caller) noexcept
+                -> detail::coro_ns::coroutine_handle<>
+            {
+                task.coro_.promise().continuation = caller;
+                return task.coro_;
+            }
+
+            auto await_resume() -> R { return task.result(); }
+        };
+        return awaiter{*this};
+    }
+
+private:
+    explicit async_task(handle_type handle) : coro_(handle) {}
+
+    handle_type coro_;
+};
+
+namespace detail {
+
+template <typename T, typename Func>
+auto async_map(async_flow<T> src, Func func)
+    -> async_flow<remove_cvref_t<std::invoke_result_t<Func&, T&&>>>
+{
+    while (auto m = co_await src.next()) {
+        co_yield invoke(func, *std::move(m));
+    }
+}
+
+template <typename T, typename Pred>
+auto async_filter(async_flow<T> src, Pred pred) -> async_flow<T>
+{
+    while (auto m = co_await src.next()) {
+        if (invoke(pred, std::as_const(*m))) {
+            co_yield *std::move(m);
+        }
+    }
+}
+
+template <typename T>
+auto async_take(async_flow<T> src, dist_t count) -> async_flow<T>
+{
+    for (; count > 0; --count) {
+        auto m = co_await src.next();
+        if (!m) {
+            break;
+        }
+        co_yield *std::move(m);
+    }
+}
+
+template <typename T>
+auto async_chunk(async_flow<T> src, dist_t size) -> async_flow<std::vector<T>>
+{
+    std::vector<T> chunk;
+    while (auto m = co_await src.next()) {
+        chunk.push_back(*std::move(m));
+        if (static_cast<dist_t>(chunk.size()) == size) {
+            co_yield std::exchange(chunk, {});
+        }
+    }
+    if (!chunk.empty()) {
+        co_yield std::move(chunk);
+    }
+}
+
+template <typename T, typename Func, typename Init>
+auto async_fold(async_flow<T> src, Func func, Init init) -> async_task<Init>
+{
+    while (auto m = co_await src.next()) {
+        init = invoke(func, std::move(init), *std::move(m));
+    }
+    co_return init;
+}
+
+template <typename T, typename Func>
+auto async_for_each(async_flow<T> src, Func func) -> async_task<Func>
+{
+    while (auto m = co_await src.next()) {
+        (void) invoke(func, *std::move(m));
+    }
+    co_return func;
+}
+
+} // namespace detail
+
+} // namespace flow
+
+#endif // FLOW_HAVE_COROUTINES
+
+#endif
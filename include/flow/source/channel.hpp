@@ -0,0 +1,440 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_SOURCE_CHANNEL_HPP_INCLUDED
+#define FLOW_SOURCE_CHANNEL_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+#include <flow/core/spin_wait.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace flow {
+
+namespace detail {
+
+inline auto channel_capacity(std::size_t requested) -> std::size_t
+{
+    std::size_t cap = 1;
+    while (cap < requested) {
+        cap *= 2;
+    }
+    return cap;
+}
+
+template <typename Channel>
+struct channel_receiver : flow_base<channel_receiver<Channel>> {
+
+    using value_type = typename Channel::value_type;
+
+    channel_receiver(Channel& channel, std::size_t batch_size)
+        : channel_(std::addressof(channel)),
+          batch_size_(batch_size)
+    {
+        assert(batch_size > 0);
+        buf_.reserve(batch_size);
+    }
+
+    auto next() -> maybe<value_type>
+    {
+        if (idx_ == buf_.size()) {
+            buf_.clear();
+            idx_ = 0;
+            if (channel_->pop_batch(std::back_inserter(buf_), batch_size_) == 0) {
+                return {};
+            }
+        }
+        return {std::move(buf_[idx_++])};
+    }
+
+private:
+    Channel* channel_;
+    std::size_t batch_size_;
+    std::vector<value_type> buf_;
+    std::size_t idx_ = 0;
+};
+
+// An output iterator which pushes each value assigned through it into a
+// channel, for use with flow::output_to()
+template <typename Channel>
+struct channel_sender {
+    using value_type = void;
+    using reference = void;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::output_iterator_tag;
+
+    constexpr channel_sender() = default;
+
+    constexpr explicit channel_sender(Channel& channel)
+        : channel_(std::addressof(channel))
+    {}
+
+    channel_sender& operator=(typename Channel::value_type const& value)
+    {
+        channel_->push(value);
+        return *this;
+    }
+
+    channel_sender& operator=(typename Channel::value_type&& value)
+    {
+        channel_->push(std::move(value));
+        return *this;
+    }
+
+    constexpr channel_sender& operator*() { return *this; }
+    constexpr channel_sender& operator++() { return *this; }
+    constexpr channel_sender& operator++(int) { return *this; }
+
+private:
+    Channel* channel_ = nullptr;
+};
+
+// The blocking operations, built on top of the derived class's
+// try_push_batch() and try_pop_batch(). A thread which has to wait for long
+// blocks on a wait_point, which the derived class notifies whenever it
+// pushes or pops.
+template <typename Derived, typename T>
+struct channel_base {
+
+    using value_type = T;
+
+    // Pushes a single value, blocking while the channel is full. Returns
+    // false (and discards the value) if the channel has been closed.
+    auto push(T value) -> bool
+    {
+        return push_batch(std::addressof(value), 1) == 1;
+    }
+
+    auto try_push(T value) -> bool
+    {
+        return derived().try_push_batch(std::addressof(value), 1) == 1;
+    }
+
+    // Moves `n` values from `first`, blocking while the channel is full.
+    // Returns the number pushed, which is less than `n` only if the
+    // channel was closed.
+    template <typename Iter>
+    auto push_batch(Iter first, std::size_t n) -> std::size_t
+    {
+        std::size_t done = 0;
+        wait_.wait_until([&] {
+            if (is_closed()) {
+                return true;
+            }
+            const std::size_t k = derived().try_push_batch(first, n - done);
+            std::advance(first, k);
+            done += k;
+            return done == n;
+        });
+        return done;
+    }
+
+    // Pushes every item of `flowable`, a batch at a time. Returns false if
+    // the channel was closed before all items could be pushed.
+    template <typename Flowable>
+    auto push_all(Flowable&& flowable) -> bool
+    {
+        static_assert(is_flowable<Flowable>,
+                      "Argument to push_all() must be a Flowable type");
+        constexpr std::size_t batch_size = 64;
+
+        std::vector<T> batch;
+        batch.reserve(batch_size);
+        auto source = FLOW_COPY(flow::from(FLOW_FWD(flowable)));
+
+        while (true) {
+            batch.clear();
+            while (batch.size() < batch_size) {
+                auto m = source.next();
+                if (!m) {
+                    break;
+                }
+                batch.push_back(*std::move(m));
+            }
+            if (batch.empty()) {
+                return true;
+            }
+            if (push_batch(batch.begin(), batch.size()) != batch.size()) {
+                return false;
+            }
+        }
+    }
+
+    // Pops a single value, blocking while the channel is empty. Returns an
+    // empty maybe once the channel is closed and drained.
+    auto pop() -> maybe<T>
+    {
+        maybe<T> out;
+        pop_batch(maybe_inserter{out}, 1);
+        return out;
+    }
+
+    auto try_pop() -> maybe<T>
+    {
+        maybe<T> out;
+        derived().try_pop_batch(maybe_inserter{out}, 1);
+        return out;
+    }
+
+    // Pops up to `max` values into `out`, blocking until at least one is
+    // available. Returns zero once the channel is closed and drained.
+    template <typename OutIter>
+    auto pop_batch(OutIter out, std::size_t max) -> std::size_t
+    {
+        std::size_t n = 0;
+        wait_.wait_until([&] {
+            // Check for closure first, so that values pushed just before
+            // closing are not missed
+            const bool closed = is_closed();
+            n = derived().try_pop_batch(out, max);
+            return n > 0 || closed;
+        });
+        return n;
+    }
+
+    // After closing, pushes fail and receivers stop once the channel is
+    // drained. Either end may close the channel.
+    void close()
+    {
+        closed_.store(true, std::memory_order_release);
+        wait_.notify_all();
+    }
+
+    [[nodiscard]] auto is_closed() const -> bool
+    {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    /// Returns a single-pass flow which pops values from the channel until
+    /// it is closed and drained. Up to `batch_size` values are removed from
+    /// the channel at a time.
+    auto receiver(std::size_t batch_size = 32) -> channel_receiver<Derived>
+    {
+        return {derived(), batch_size};
+    }
+
+    /// Returns an output iterator which pushes into the channel
+    auto sender() -> channel_sender<Derived>
+    {
+        return channel_sender<Derived>{derived()};
+    }
+
+protected:
+    // Called by the derived class whenever values are pushed or popped, to
+    // wake any threads blocked in push_batch() or pop_batch()
+    void notify_waiters() { wait_.notify_all(); }
+
+private:
+    struct maybe_inserter {
+        using value_type = void;
+        using reference = void;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::output_iterator_tag;
+
+        maybe<T>& m;
+
+        maybe_inserter& operator=(T&& value) { m = maybe<T>(std::move(value)); return *this; }
+        maybe_inserter& operator*() { return *this; }
+        maybe_inserter& operator++() { return *this; }
+        maybe_inserter& operator++(int) { return *this; }
+    };
+
+    auto derived() -> Derived& { return static_cast<Derived&>(*this); }
+
+    std::atomic<bool> closed_{false};
+    wait_point wait_;
+};
+
+} // namespace detail
+
+/// A bounded, lock-free queue for passing values from exactly one producer
+/// thread to exactly one consumer thread.
+///
+/// The capacity is rounded up to a power of two.
+template <typename T>
+struct spsc_channel : detail::channel_base<spsc_channel<T>, T> {
+
+    explicit spsc_channel(std::size_t capacity)
+        : cap_(detail::channel_capacity(capacity)),
+          slots_(std::make_unique<maybe<T>[]>(cap_))
+    {}
+
+    spsc_channel(spsc_channel const&) = delete;
+    spsc_channel& operator=(spsc_channel const&) = delete;
+
+    [[nodiscard]] auto capacity() const -> std::size_t { return cap_; }
+
+    // Producer: moves up to `n` values from `first` without blocking,
+    // returning the number pushed
+    template <typename Iter>
+    auto try_push_batch(Iter first, std::size_t n) -> std::size_t
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (cap_ - (tail - head_cache_) < n) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+        }
+        const std::size_t k = detail::min(n, cap_ - (tail - head_cache_));
+        for (std::size_t i = 0; i < k; i++, ++first) {
+            slots_[(tail + i) & (cap_ - 1)] = maybe<T>(std::move(*first));
+        }
+        if (k > 0) {
+            tail_.store(tail + k, std::memory_order_release);
+            this->notify_waiters();
+        }
+        return k;
+    }
+
+    // Consumer: moves up to `max` values into `out` without blocking,
+    // returning the number popped
+    template <typename OutIter>
+    auto try_pop_batch(OutIter out, std::size_t max) -> std::size_t
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (tail_cache_ - head < max) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+        }
+        const std::size_t k = detail::min(max, tail_cache_ - head);
+        for (std::size_t i = 0; i < k; i++) {
+            auto& slot = slots_[(head + i) & (cap_ - 1)];
+            *out = *std::move(slot);
+            ++out;
+            slot.reset();
+        }
+        if (k > 0) {
+            head_.store(head + k, std::memory_order_release);
+            this->notify_waiters();
+        }
+        return k;
+    }
+
+private:
+    std::size_t cap_;
+    std::unique_ptr<maybe<T>[]> slots_;
+    // Each side keeps a cached copy of the other side's index, so that it
+    // only touches the other's cache line when it appears to be blocked
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_ = 0;
+};
+
+/// A bounded, lock-free queue which may be used by any number of producer
+/// and consumer threads.
+///
+/// This is Dmitry Vyukov's bounded MPMC queue: each slot carries a sequence
+/// number recording whether it is ready to be written or read in the current
+/// lap, so producers and consumers only contend on the head or tail index.
+/// Batch operations claim several consecutive ready slots with a single
+/// compare-exchange. The capacity is rounded up to a power of two.
+template <typename T>
+struct channel : detail::channel_base<channel<T>, T> {
+
+    explicit channel(std::size_t capacity)
+        : cap_(detail::channel_capacity(capacity)),
+          slots_(std::make_unique<slot[]>(cap_))
+    {
+        for (std::size_t i = 0; i < cap_; i++) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    channel(channel const&) = delete;
+    channel& operator=(channel const&) = delete;
+
+    [[nodiscard]] auto capacity() const -> std::size_t { return cap_; }
+
+    template <typename Iter>
+    auto try_push_batch(Iter first, std::size_t n) -> std::size_t
+    {
+        auto pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            const std::size_t k = count_ready(pos, n, 0);
+            if (k == 0) {
+                if (lags(get(pos).seq.load(std::memory_order_acquire), pos)) {
+                    return 0; // full
+                }
+                pos = tail_.load(std::memory_order_relaxed);
+            } else if (tail_.compare_exchange_weak(pos, pos + k,
+                                                   std::memory_order_relaxed)) {
+                for (std::size_t i = 0; i < k; i++, ++first) {
+                    auto& s = get(pos + i);
+                    s.value = maybe<T>(std::move(*first));
+                    s.seq.store(pos + i + 1, std::memory_order_release);
+                }
+                this->notify_waiters();
+                return k;
+            }
+        }
+    }
+
+    template <typename OutIter>
+    auto try_pop_batch(OutIter out, std::size_t max) -> std::size_t
+    {
+        auto pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            const std::size_t k = count_ready(pos, max, 1);
+            if (k == 0) {
+                if (lags(get(pos).seq.load(std::memory_order_acquire), pos + 1)) {
+                    return 0; // empty
+                }
+                pos = head_.load(std::memory_order_relaxed);
+            } else if (head_.compare_exchange_weak(pos, pos + k,
+                                                   std::memory_order_relaxed)) {
+                for (std::size_t i = 0; i < k; i++) {
+                    auto& s = get(pos + i);
+                    *out = *std::move(s.value);
+                    ++out;
+                    s.value.reset();
+                    s.seq.store(pos + i + cap_, std::memory_order_release);
+                }
+                this->notify_waiters();
+                return k;
+            }
+        }
+    }
+
+private:
+    struct slot {
+        std::atomic<std::size_t> seq;
+        maybe<T> value;
+    };
+
+    auto get(std::size_t pos) -> slot& { return slots_[pos & (cap_ - 1)]; }
+
+    // True if a slot with sequence number `seq` has not yet reached `want`
+    static auto lags(std::size_t seq, std::size_t want) -> bool
+    {
+        return static_cast<std::ptrdiff_t>(seq - want) < 0;
+    }
+
+    // Counts the consecutive slots from `pos` whose sequence number is
+    // `pos + i + offset`, which means that they are ready for us
+    auto count_ready(std::size_t pos, std::size_t max, std::size_t offset)
+        -> std::size_t
+    {
+        std::size_t k = 0;
+        while (k < max &&
+               get(pos + k).seq.load(std::memory_order_acquire) == pos + k + offset) {
+            ++k;
+        }
+        return k;
+    }
+
+    std::size_t cap_;
+    std::unique_ptr<slot[]> slots_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,276 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_SOURCE_COMPRESSED_HPP_INCLUDED
+#define FLOW_SOURCE_COMPRESSED_HPP_INCLUDED
+
+//
+// Streaming decompression sources. These are only available when the
+// corresponding library is found by CMake, which defines FLOW_HAVE_ZLIB
+// and/or FLOW_HAVE_ZSTD and links the library.
+//
+
+#include <flow/core/macros.hpp>
+
+#if defined(FLOW_HAVE_ZLIB) || defined(FLOW_HAVE_ZSTD)
+
+#include <flow/core/char_window.hpp>
+#include <flow/core/flow_base.hpp>
+
+#include <climits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#ifdef FLOW_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef FLOW_HAVE_ZSTD
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+
+namespace flow {
+
+namespace detail {
+
+enum class codec_status { ok, stream_end, error };
+
+// Codecs decompress from `in` into [out, out_end) with step(), advancing
+// both, and report stream_end at the end of each compressed stream. Since
+// compressed files may be concatenated, reset() prepares for another.
+
+#ifdef FLOW_HAVE_ZLIB
+struct gzip_codec {
+    // zlib's own code for input which ends in the middle of a stream
+    static constexpr int truncated_error = Z_BUF_ERROR;
+
+    gzip_codec()
+    {
+        // Adding 32 to the window bits detects both gzip and zlib headers
+        if (inflateInit2(&strm_, 15 + 32) != Z_OK) {
+            error_ = Z_MEM_ERROR;
+        }
+    }
+
+    gzip_codec(gzip_codec const&) = delete;
+    gzip_codec& operator=(gzip_codec const&) = delete;
+
+    ~gzip_codec() { inflateEnd(&strm_); }
+
+    auto step(std::string_view& in, char*& out, char* out_end) -> codec_status
+    {
+        if (error_ != Z_OK) {
+            return codec_status::error;
+        }
+
+        strm_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+        strm_.avail_in = static_cast<uInt>(detail::min(in.size(), std::size_t{UINT_MAX}));
+        strm_.next_out = reinterpret_cast<Bytef*>(out);
+        strm_.avail_out = static_cast<uInt>(
+            detail::min(static_cast<std::size_t>(out_end - out), std::size_t{UINT_MAX}));
+        const uInt avail_in = strm_.avail_in;
+        const uInt avail_out = strm_.avail_out;
+
+        const int ret = inflate(&strm_, Z_NO_FLUSH);
+
+        in.remove_prefix(avail_in - strm_.avail_in);
+        out += avail_out - strm_.avail_out;
+
+        switch (ret) {
+        case Z_OK:
+        case Z_BUF_ERROR: // no progress possible yet
+            return codec_status::ok;
+        case Z_STREAM_END:
+            return codec_status::stream_end;
+        default:
+            error_ = ret;
+            return codec_status::error;
+        }
+    }
+
+    void reset() { inflateReset(&strm_); }
+
+    [[nodiscard]] auto error() const -> int { return error_; }
+
+private:
+    z_stream strm_{};
+    int error_ = Z_OK;
+};
+#endif // FLOW_HAVE_ZLIB
+
+#ifdef FLOW_HAVE_ZSTD
+struct zstd_codec {
+    static constexpr int truncated_error = ZSTD_error_srcSize_wrong;
+
+    zstd_codec() = default;
+
+    zstd_codec(zstd_codec const&) = delete;
+    zstd_codec& operator=(zstd_codec const&) = delete;
+
+    ~zstd_codec() { ZSTD_freeDStream(stream_); }
+
+    auto step(std::string_view& in, char*& out, char* out_end) -> codec_status
+    {
+        if (!stream_) {
+            error_ = ZSTD_error_memory_allocation;
+            return codec_status::error;
+        }
+
+        ZSTD_inBuffer ibuf{in.data(), in.size(), 0};
+        ZSTD_outBuffer obuf{out, static_cast<std::size_t>(out_end - out), 0};
+
+        const std::size_t ret = ZSTD_decompressStream(stream_, &obuf, &ibuf);
+
+        in.remove_prefix(ibuf.pos);
+        out += obuf.pos;
+
+        if (ZSTD_isError(ret)) {
+            error_ = static_cast<int>(ZSTD_getErrorCode(ret));
+            return codec_status::error;
+        }
+        // Zero means that a frame has been completely decoded and flushed
+        return ret == 0 ? codec_status::stream_end : codec_status::ok;
+    }
+
+    // The next frame is started automatically
+    void reset() {}
+
+    [[nodiscard]] auto error() const -> int { return error_; }
+
+private:
+    ZSTD_DStream* stream_ = ZSTD_createDStream();
+    int error_ = 0;
+};
+#endif // FLOW_HAVE_ZSTD
+
+template <typename Codec, typename Reader>
+struct decompress_flow : flow_base<decompress_flow<Codec, Reader>> {
+
+    explicit decompress_flow(Reader reader)
+        : state_(std::make_unique<state>(std::move(reader)))
+    {}
+
+    decompress_flow(decompress_flow&&) noexcept = default;
+    decompress_flow& operator=(decompress_flow&&) noexcept = default;
+
+    auto next() -> maybe<std::string_view>
+    {
+        auto& s = *state_;
+        char* const first = s.out_buf.data();
+        char* const last = first + s.out_buf.size();
+        char* out = first;
+
+        while (out != last && !s.done) {
+            if (s.in.empty()) {
+                const std::size_t n = s.reader.read(s.in_buf.data(), s.in_buf.size());
+                if (n == 0) {
+                    if (s.mid_stream) {
+                        s.error = Codec::truncated_error;
+                    }
+                    s.done = true;
+                    break;
+                }
+                s.in = std::string_view(s.in_buf.data(), n);
+            }
+
+            s.mid_stream = true;
+            switch (s.codec.step(s.in, out, last)) {
+            case codec_status::ok:
+                break;
+            case codec_status::stream_end:
+                s.mid_stream = false;
+                s.codec.reset();
+                break;
+            case codec_status::error:
+                s.error = s.codec.error();
+                s.done = true;
+                break;
+            }
+        }
+
+        if (out == first) {
+            return {};
+        }
+        return std::string_view(first, static_cast<std::size_t>(out - first));
+    }
+
+    /// Returns the library-specific code for the error which ended the flow
+    /// early, or zero. Only meaningful once `next()` has returned an empty
+    /// `maybe`.
+    [[nodiscard]] auto error() const -> int
+    {
+        return state_->error;
+    }
+
+private:
+    // Codecs hold pointers to themselves, so must not move
+    struct state {
+        explicit state(Reader&& reader) : reader(std::move(reader)) {}
+
+        Reader reader;
+        Codec codec;
+        std::vector<char> in_buf = std::vector<char>(read_block_size);
+        std::vector<char> out_buf = std::vector<char>(read_block_size);
+        std::string_view in;
+        bool mid_stream = false;
+        bool done = false;
+        int error = 0;
+    };
+
+    std::unique_ptr<state> state_;
+};
+
+template <typename Codec>
+struct decompress_fn {
+    template <typename Source>
+    auto operator()(Source&& source) const
+        -> decompress_flow<Codec, decltype(make_reader(FLOW_FWD(source)))>
+    {
+        using reader_t = decltype(make_reader(FLOW_FWD(source)));
+        return decompress_flow<Codec, reader_t>(make_reader(FLOW_FWD(source)));
+    }
+};
+
+} // namespace detail
+
+#ifdef FLOW_HAVE_ZLIB
+/// Returns a single-pass flow which decompresses gzip (or zlib) data from
+/// `source`, block by block.
+///
+/// The source may be a `std::string_view`, a `std::streambuf*`, a
+/// `std::istream&`, a `std::FILE*` or a flow whose items are chunks of
+/// characters (such as `from_file_prefetched()`). Concatenated gzip members,
+/// as produced by appending to a `.gz` file, are decompressed in turn.
+///
+/// Each item is a `std::string_view` over a chunk of decompressed data,
+/// valid only until the next call to `next()`. Use `flatten()` to obtain a
+/// flow of characters, `from_lines()` to split it into lines, or
+/// `read_ahead()` to decompress on a separate thread.
+///
+/// If the data is corrupt or truncated, the flow ends early and its
+/// `error()` member function returns the zlib error code.
+///
+/// @note Only available if zlib was found when configuring the library
+inline constexpr auto from_gzip = detail::decompress_fn<detail::gzip_codec>{};
+#endif
+
+#ifdef FLOW_HAVE_ZSTD
+/// Returns a single-pass flow which decompresses Zstandard data from
+/// `source`, block by block.
+///
+/// This works in the same way as `from_gzip()`. On failure, the flow's
+/// `error()` member function returns a `ZSTD_ErrorCode`.
+///
+/// @note Only available if libzstd was found when configuring the library
+inline constexpr auto from_zstd = detail::decompress_fn<detail::zstd_codec>{};
+#endif
+
+}
+
+#endif // FLOW_HAVE_ZLIB || FLOW_HAVE_ZSTD
+
+#endif
@@ -81,15 +81,63 @@ template <typename R>
 inline constexpr bool is_random_access_stl_range =
     std::is_base_of_v<std::random_access_iterator_tag, iter_category_t<R>>;
 
+template <typename, typename = void>
+inline constexpr bool is_contiguous_stl_range = false;
+
+template <typename R>
+inline constexpr bool is_contiguous_stl_range<
+    R, std::enable_if_t<std::is_pointer_v<decltype(std::data(std::declval<R&>()))>>> = true;
+
 template <typename R>
 struct range_ref {
     constexpr range_ref(R& rng) : ptr_(std::addressof(rng)) {}
 
-    constexpr auto begin() const { return detail::begin(*ptr_); }
-    constexpr auto end() const { return detail::end(*ptr_); }
+    constexpr auto begin() const { return std::next(detail::begin(*ptr_), first_); }
+
+    constexpr auto end() const
+    {
+        if (last_ < 0) {
+            return detail::end(*ptr_);
+        }
+        return std::next(detail::begin(*ptr_), last_);
+    }
+
+    template <typename RR = R, std::enable_if_t<is_contiguous_stl_range<RR>, int> = 0>
+    constexpr auto data() const { return std::data(*ptr_) + first_; }
+
+    // Refers to the sub-range [first, last) of this range
+    constexpr auto sub(dist_t first, dist_t last) const -> range_ref
+    {
+        range_ref r = *this;
+        r.first_ = first_ + first;
+        r.last_ = first_ + last;
+        return r;
+    }
 
 private:
     R* ptr_;
+    dist_t first_ = 0;
+    dist_t last_ = -1; // -1 means the end of *ptr_
+};
+
+// An owned random-access range, of which only [first, last) is exposed
+template <typename R>
+struct owning_subrange {
+    constexpr owning_subrange(R&& rng, dist_t first, dist_t last)
+        : rng_(std::move(rng)), first_(first), last_(last)
+    {}
+
+    constexpr auto begin() { return detail::begin(rng_) + first_; }
+    constexpr auto end() { return detail::begin(rng_) + last_; }
+    constexpr auto begin() const { return detail::begin(rng_) + first_; }
+    constexpr auto end() const { return detail::begin(rng_) + last_; }
+
+    constexpr auto size() const -> dist_t { return last_ - first_; }
+
+private:
+    R rng_;
+    dist_t first_;
+    dist_t last_;
 };
 
 template <typename>
@@ -238,6 +286,8 @@ private:
 template <typename R>
 struct stl_ra_range_adaptor : flow_base<stl_ra_range_adaptor<R>> {
 
+    static constexpr bool is_random_access = true;
+
     template <typename RR = R, std::enable_if_t<!std::is_array_v<RR>, int> = 0>
     constexpr explicit stl_ra_range_adaptor(R&& rng) : rng_(FLOW_FWD(rng))
     {}
@@ -253,6 +303,11 @@ struct stl_ra_range_adaptor : flow_base<stl_ra_range_adaptor<R>> {
         }
     }
 
+    // Adapts the sub-range [first, last) of `rng`
+    constexpr stl_ra_range_adaptor(R&& rng, dist_t first, dist_t last)
+        : rng_(FLOW_FWD(rng)), idx_(first), idx_back_(last)
+    {}
+
     constexpr auto next() -> maybe<iter_reference_t<R>>
     {
         if (idx_ < idx_back_) {
@@ -276,18 +331,50 @@ struct stl_ra_range_adaptor : flow_base<stl_ra_range_adaptor<R>> {
         return next();
     }
 
+    // Works on a local copy of the index, so that it can stay in a register
+    // even though the callback may write through a pointer
+    template <typename Func, typename Init>
+    constexpr auto try_fold(Func func, Init init) -> Init
+    {
+        auto first = detail::begin(rng_);
+        dist_t idx = idx_;
+        while (idx < idx_back_) {
+            init = invoke(func, std::move(init), maybe<iter_reference_t<R>>(first[idx++]));
+            if (!static_cast<bool>(init)) {
+                break;
+            }
+        }
+        idx_ = idx;
+        return init;
+    }
+
+    // The range can only be moved out as-is if it is exactly what remains
+    // of this flow, which is not the case if we were constructed with bounds
+    // or some items have already been consumed
     constexpr auto to_range() &&
     {
-        return std::move(rng_);
+        if constexpr (std::is_array_v<R>) {
+            return std::move(*this).flow_base<stl_ra_range_adaptor>::to_range();
+        } else if constexpr (is_range_ref<R> || is_iterator_constructible_) {
+            if (is_whole_()) {
+                return std::move(rng_);
+            }
+            return std::move(*this).remaining_();
+        } else {
+            return owning_subrange<R>(std::move(rng_), idx_, idx_back_);
+        }
     }
 
     template <typename C>
     constexpr auto to() &&
     {
         if constexpr (std::is_same_v<C, R>) {
-            return std::move(rng_);
+            if (is_whole_()) {
+                return std::move(rng_);
+            }
+            return std::move(*this).remaining_();
         } else {
-            return C(detail::begin(rng_) + idx_, detail::end(rng_));
+            return C(detail::begin(rng_) + idx_, detail::begin(rng_) + idx_back_);
         }
     }
 
@@ -298,6 +385,7 @@ struct stl_ra_range_adaptor : flow_base<stl_ra_range_adaptor<R>> {
         } else {
             auto f = stl_ra_range_adaptor<range_ref<R>>(rng_);
             f.idx_ = idx_;
+            f.idx_back_ = idx_back_;
             return f;
         }
     }
@@ -307,10 +395,46 @@ struct stl_ra_range_adaptor : flow_base<stl_ra_range_adaptor<R>> {
         return idx_back_ - idx_;
     }
 
+    // Pointer to the next item, for contiguous ranges
+    template <typename RR = R, std::enable_if_t<is_contiguous_stl_range<RR>, int> = 0>
+    constexpr auto data()
+    {
+        return std::data(rng_) + idx_;
+    }
+
 private:
     template <typename>
     friend struct stl_ra_range_adaptor;
 
+    static constexpr bool is_iterator_constructible_ =
+        std::is_constructible_v<R, iterator_t<R>, iterator_t<R>>;
+
+    constexpr auto is_whole_() const -> bool
+    {
+        return idx_ == 0 &&
+               idx_back_ == std::distance(detail::begin(rng_), detail::end(rng_));
+    }
+
+    // A range of type R holding just the items in [idx_, idx_back_)
+    constexpr auto remaining_() &&
+    {
+        auto first = detail::begin(rng_);
+        if constexpr (is_range_ref<R>) {
+            return rng_.sub(idx_, idx_back_);
+        } else if constexpr (is_iterator_constructible_) {
+            return R(first + idx_, first + idx_back_);
+        } else {
+            // e.g. std::array: the items are moved to the front, and the
+            // remainder is value-initialised
+            R out{};
+            auto out_first = detail::begin(out);
+            for (dist_t i = idx_; i < idx_back_; ++i) {
+                out_first[i - idx_] = std::move(first[i]);
+            }
+            return out;
+        }
+    }
+
     R rng_{};
     dist_t idx_ = 0;
     dist_t idx_back_ = std::distance(detail::begin(rng_), detail::end(rng_));
@@ -0,0 +1,170 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_SOURCE_FROM_CHARS_HPP_INCLUDED
+#define FLOW_SOURCE_FROM_CHARS_HPP_INCLUDED
+
+#include <flow/core/char_window.hpp>
+#include <flow/core/flow_base.hpp>
+
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace flow {
+
+namespace detail {
+
+inline constexpr std::string_view default_delimiters = " \t\n\v\f\r";
+
+struct delimiter_set {
+    constexpr explicit delimiter_set(std::string_view delims)
+    {
+        for (char c : delims) {
+            table_[static_cast<unsigned char>(c)] = true;
+        }
+    }
+
+    constexpr auto operator()(char c) const -> bool
+    {
+        return table_[static_cast<unsigned char>(c)];
+    }
+
+private:
+    std::array<bool, 256> table_{};
+};
+
+template <typename T, typename Reader>
+struct from_chars_flow : flow_base<from_chars_flow<T, Reader>> {
+
+    template <typename Src>
+    from_chars_flow(Src src, std::string_view delims)
+        : window_(std::move(src)),
+          is_delim_(delims)
+    {}
+
+    // Move-only
+    from_chars_flow(from_chars_flow&&) = default;
+    from_chars_flow& operator=(from_chars_flow&&) = default;
+
+    auto next() -> maybe<T>
+    {
+        while (true) {
+            const char* first = window_.begin();
+            const char* const last = window_.end();
+
+            while (first != last && is_delim_(*first)) {
+                ++first;
+            }
+            window_.consume_to(first);
+
+            if (first == last) {
+                if (!window_.refill()) {
+                    return {};
+                }
+                continue;
+            }
+
+            T val{};
+            const auto [ptr, ec] = std::from_chars(first, last, val);
+
+            // If the token runs up to the end of the window, there may be
+            // more of it still to read
+            if (!window_.at_end() && (ptr == last || !is_delim_(*ptr))) {
+                const char* tok_end = ptr;
+                while (tok_end != last && !is_delim_(*tok_end)) {
+                    ++tok_end;
+                }
+                if (tok_end == last) {
+                    (void) window_.refill();
+                    continue;
+                }
+            }
+
+            // Like istream_flow, we stop at the first token we cannot parse
+            if (ec != std::errc{} || (ptr != last && !is_delim_(*ptr))) {
+                window_.clear();
+                return {};
+            }
+
+            window_.consume_to(ptr);
+            return val;
+        }
+    }
+
+private:
+    char_window<Reader> window_;
+    delimiter_set is_delim_;
+};
+
+template <typename T>
+struct from_chars_fn {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "flow::from_chars() can only parse integer and floating-point types");
+
+    auto operator()(std::string_view chars,
+                    std::string_view delims = default_delimiters) const
+    {
+        return from_chars_flow<T, no_reader>(chars, delims);
+    }
+
+    // The flow would refer to a destroyed string
+    template <typename Traits, typename Alloc>
+    auto operator()(std::basic_string<char, Traits, Alloc>&&,
+                    std::string_view = {}) const = delete;
+
+    auto operator()(std::streambuf* buf,
+                    std::string_view delims = default_delimiters) const
+    {
+        return from_chars_flow<T, streambuf_reader>(streambuf_reader{buf}, delims);
+    }
+
+    auto operator()(std::istream& is,
+                    std::string_view delims = default_delimiters) const
+    {
+        return (*this)(is.rdbuf(), delims);
+    }
+
+    auto operator()(std::FILE* file,
+                    std::string_view delims = default_delimiters) const
+    {
+        return from_chars_flow<T, file_reader>(file_reader{file}, delims);
+    }
+
+    template <typename Flow, std::enable_if_t<is_chunk_flow<Flow>, int> = 0>
+    auto operator()(Flow flow, std::string_view delims = default_delimiters) const
+    {
+        return from_chars_flow<T, chunk_reader<Flow>>(
+            chunk_reader<Flow>{std::move(flow)}, delims);
+    }
+};
+
+} // namespace detail
+
+/// Returns a flow which lazily parses values of type `T` from a sequence of
+/// characters, using `std::from_chars()`.
+///
+/// The source may be a `std::string_view` (or anything convertible to one,
+/// such as a memory-mapped file), a `std::streambuf*`, a `std::istream&`,
+/// a `std::FILE*`, or a flow whose items are chunks of characters (such as
+/// `from_file_prefetched()`). Streams and files are read in large blocks,
+/// bypassing the formatted input functions (and the locale) entirely.
+///
+/// Values are separated by one or more of the characters in `delims`, which
+/// defaults to whitespace. Each value must be in the format accepted by
+/// `std::from_chars()`: in particular, a leading `+` is not permitted. As
+/// with `from_istream()`, the flow ends at the first value which cannot be
+/// parsed, or which is out of range for `T`.
+///
+/// @tparam T An integer or floating-point type to parse
+template <typename T>
+inline constexpr auto from_chars = detail::from_chars_fn<T>{};
+
+}
+
+#endif
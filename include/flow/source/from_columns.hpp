@@ -0,0 +1,171 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_SOURCE_FROM_COLUMNS_HPP_INCLUDED
+#define FLOW_SOURCE_FROM_COLUMNS_HPP_INCLUDED
+
+#include <flow/core/flow_base.hpp>
+#include <flow/source/from.hpp>
+
+#include <limits>
+#include <tuple>
+
+namespace flow {
+
+namespace detail {
+
+template <typename R>
+using column_storage_t =
+    std::conditional_t<std::is_lvalue_reference_v<R>,
+                       range_ref<std::remove_reference_t<R>>, R>;
+
+template <typename R>
+using column_ref_t = std::conditional_t<is_range_ref<R>, R, range_ref<R>>;
+
+// As with zip(), rows of two columns are pairs, so that keys() and values()
+// work as expected
+template <typename... Refs>
+struct column_row {
+    using type = std::tuple<Refs...>;
+};
+
+template <typename R1, typename R2>
+struct column_row<R1, R2> {
+    using type = std::pair<R1, R2>;
+};
+
+template <typename... Cols>
+using column_row_t = typename column_row<iter_reference_t<Cols>...>::type;
+
+template <typename... Cols>
+struct columns_flow : flow_base<columns_flow<Cols...>> {
+
+    static constexpr bool is_random_access = true;
+
+    using item_type = column_row_t<Cols...>;
+
+    constexpr explicit columns_flow(Cols&&... cols)
+        : cols_(std::move(cols)...)
+    {}
+
+    constexpr auto next() -> maybe<item_type>
+    {
+        if (idx_ < idx_back_) {
+            return {row(idx_++)};
+        }
+        return {};
+    }
+
+    constexpr auto next_back() -> maybe<item_type>
+    {
+        if (idx_back_ > idx_) {
+            return {row(--idx_back_)};
+        }
+        return {};
+    }
+
+    constexpr auto advance(dist_t dist) -> maybe<item_type>
+    {
+        assert(dist > 0);
+        idx_ += dist - 1;
+        return next();
+    }
+
+    constexpr auto subflow() & -> columns_flow<column_ref_t<Cols>...>
+    {
+        auto f = std::apply([](auto&... cols) {
+            return columns_flow<column_ref_t<Cols>...>(column_ref_t<Cols>(cols)...);
+        }, cols_);
+        f.idx_ = idx_;
+        f.idx_back_ = idx_back_;
+        return f;
+    }
+
+    [[nodiscard]] constexpr auto size() const -> dist_t
+    {
+        return idx_back_ - idx_;
+    }
+
+    /// Consumes the flow, returning a flow over the remaining items of the
+    /// `N`th column alone. The other columns are never touched.
+    ///
+    /// If the column is contiguous then so is the returned flow.
+    ///
+    /// This is used by `elements<N>()`, `keys()` and `values()`, so that
+    /// projecting a single column does not need to go through a row.
+    template <std::size_t N>
+    constexpr auto column() &&
+    {
+        using col_t = std::tuple_element_t<N, std::tuple<Cols...>>;
+        return stl_ra_range_adaptor<col_t>(std::get<N>(std::move(cols_)),
+                                           idx_, idx_back_);
+    }
+
+private:
+    template <typename...>
+    friend struct columns_flow;
+
+    constexpr auto row(dist_t idx) -> item_type
+    {
+        return std::apply([idx](auto&... cols) {
+            return item_type(detail::begin(cols)[idx]...);
+        }, cols_);
+    }
+
+    // The shortest column determines the number of rows
+    constexpr auto num_rows() -> dist_t
+    {
+        return std::apply([](auto&... cols) {
+            dist_t rows = std::numeric_limits<dist_t>::max();
+            ((rows = detail::min(rows, static_cast<dist_t>(std::distance(
+                  detail::begin(cols), detail::end(cols))))), ...);
+            return rows;
+        }, cols_);
+    }
+
+    std::tuple<Cols...> cols_;
+    dist_t idx_ = 0;
+    dist_t idx_back_ = num_rows();
+};
+
+struct from_columns_fn {
+    template <typename Col0, typename... Cols>
+    constexpr auto operator()(Col0&& col0, Cols&&... cols) const
+    {
+        static_assert(is_random_access_stl_range<Col0> &&
+                      (is_random_access_stl_range<Cols> && ...),
+                      "All arguments to flow::from_columns() must be random-access ranges");
+        static_assert(!std::is_array_v<remove_cvref_t<Col0>> &&
+                      !(std::is_array_v<remove_cvref_t<Cols>> || ...),
+                      "Arguments to flow::from_columns() must not be raw arrays");
+
+        return columns_flow<column_storage_t<Col0>, column_storage_t<Cols>...>(
+            FLOW_FWD(col0), FLOW_FWD(cols)...);
+    }
+};
+
+} // namespace detail
+
+/// Creates a random-access flow over a table stored as a "structure of arrays",
+/// where each argument is one column.
+///
+/// Each item is a `std::tuple` of references to the elements of the same
+/// row (or a `std::pair` when there are two columns). The flow has as many
+/// items as the shortest column.
+///
+/// Unlike `zip()`, calling `elements<N>()`, `keys()` or `values()` directly
+/// on the resulting flow yields a flow over the `N`th column alone, which is
+/// contiguous if the column is.
+///
+/// Columns passed as lvalues are referenced; those passed as rvalues are
+/// moved into the flow.
+///
+/// @param cols Random-access ranges, each holding one column of the table
+/// @return A new columns flow
+inline constexpr auto from_columns = detail::from_columns_fn{};
+
+}
+
+#endif
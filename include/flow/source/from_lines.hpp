@@ -0,0 +1,136 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_SOURCE_FROM_LINES_HPP_INCLUDED
+#define FLOW_SOURCE_FROM_LINES_HPP_INCLUDED
+
+#include <flow/core/char_window.hpp>
+#include <flow/core/flow_base.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace flow {
+
+namespace detail {
+
+template <typename Reader>
+struct lines_flow : flow_base<lines_flow<Reader>> {
+
+    template <typename Src>
+    lines_flow(Src src, bool strip_cr)
+        : window_(std::move(src)),
+          strip_cr_(strip_cr)
+    {}
+
+    // Move-only
+    lines_flow(lines_flow&&) = default;
+    lines_flow& operator=(lines_flow&&) = default;
+
+    auto next() -> maybe<std::string_view>
+    {
+        // The number of characters already searched for a newline, which
+        // remains valid when the window is refilled
+        std::size_t searched = 0;
+
+        while (true) {
+            const char* const first = window_.begin();
+            const auto len = static_cast<std::size_t>(window_.end() - first);
+
+            if (searched < len) {
+                if (auto nl = static_cast<const char*>(
+                        std::memchr(first + searched, '\n', len - searched))) {
+                    window_.consume_to(nl + 1);
+                    return line(first, nl);
+                }
+                searched = len;
+            }
+
+            if (!window_.refill()) {
+                // The final line may not end with a newline
+                const char* const rest = window_.begin();
+                const char* const last = window_.end();
+                if (rest == last) {
+                    return {};
+                }
+                window_.consume_to(last);
+                return line(rest, last);
+            }
+        }
+    }
+
+private:
+    auto line(const char* first, const char* last) const -> std::string_view
+    {
+        if (strip_cr_ && first != last && *(last - 1) == '\r') {
+            --last;
+        }
+        return std::string_view(first, static_cast<std::size_t>(last - first));
+    }
+
+    char_window<Reader> window_;
+    bool strip_cr_;
+};
+
+struct from_lines_fn {
+
+    auto operator()(std::string_view chars, bool strip_cr = false) const
+    {
+        return lines_flow<no_reader>(chars, strip_cr);
+    }
+
+    // The flow would refer to a destroyed string
+    template <typename Traits, typename Alloc>
+    auto operator()(std::basic_string<char, Traits, Alloc>&&, bool = false) const = delete;
+
+    auto operator()(std::streambuf* buf, bool strip_cr = false) const
+    {
+        return lines_flow<streambuf_reader>(streambuf_reader{buf}, strip_cr);
+    }
+
+    auto operator()(std::istream& is, bool strip_cr = false) const
+    {
+        return (*this)(is.rdbuf(), strip_cr);
+    }
+
+    auto operator()(std::FILE* file, bool strip_cr = false) const
+    {
+        return lines_flow<file_reader>(file_reader{file}, strip_cr);
+    }
+
+    template <typename Flow, std::enable_if_t<is_chunk_flow<Flow>, int> = 0>
+    auto operator()(Flow flow, bool strip_cr = false) const
+    {
+        return lines_flow<chunk_reader<Flow>>(chunk_reader<Flow>{std::move(flow)}, strip_cr);
+    }
+};
+
+} // namespace detail
+
+/// Returns a flow over the lines of the given source, without their
+/// terminating newline characters.
+///
+/// The source may be a `std::string_view` (or anything convertible to one),
+/// a `std::streambuf*`, a `std::istream&`, a `std::FILE*`, or a flow whose
+/// items are chunks of characters (such as `from_file_prefetched()`).
+/// Streams and files are read in large blocks.
+///
+/// Each item is a `std::string_view` referring directly to the source's
+/// characters, or to an internal buffer when reading from a stream or file.
+/// In the latter case the view is only valid until the next call to
+/// `next()`: to keep lines for longer, copy them into `std::string`s (for
+/// example with `map()`).
+///
+/// @param source The characters to split into lines
+/// @param strip_cr If true, a carriage return at the end of each line (as
+///                 used by CRLF line endings) is removed as well
+inline constexpr auto from_lines = detail::from_lines_fn{};
+
+}
+
+#endif
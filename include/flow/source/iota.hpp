@@ -41,6 +41,14 @@ struct iota_flow : flow_base<iota_flow<Val>> {
         return {val_++};
     }
 
+    template <typename V = Val, std::enable_if_t<std::is_integral_v<V>, int> = 0>
+    constexpr auto advance(dist_t dist) -> maybe<Val>
+    {
+        assert(dist > 0);
+        val_ += static_cast<Val>(dist - 1);
+        return next();
+    }
+
 private:
     Val val_;
 };
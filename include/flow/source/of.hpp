@@ -21,6 +21,9 @@ using array_flow = decltype(flow::from(std::declval<std::array<T, N>>()));
 
 template <typename T, std::size_t N>
 struct of : flow_base<of<T, N>> {
+
+    static constexpr bool is_random_access = true;
+
     template <typename... Args>
     constexpr explicit of(Args&&... args)
         : arr_(flow::from(std::array<T, N>{FLOW_FWD(args)...}))
@@ -34,6 +37,10 @@ struct of : flow_base<of<T, N>> {
         return arr_.next_back();
     }
 
+    constexpr auto advance(dist_t dist) -> maybe<T&> {
+        return arr_.advance(dist);
+    }
+
     constexpr auto subflow() &
     {
         return arr_.subflow();
@@ -44,6 +51,11 @@ struct of : flow_base<of<T, N>> {
         return arr_.size();
     }
 
+    constexpr auto data() -> T*
+    {
+        return arr_.data();
+    }
+
 private:
     detail::array_flow<T, N> arr_;
 };
@@ -0,0 +1,378 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FLOW_SOURCE_PREFETCH_HPP_INCLUDED
+#define FLOW_SOURCE_PREFETCH_HPP_INCLUDED
+
+#include <flow/core/macros.hpp>
+
+#ifdef FLOW_HAVE_POSIX_IO
+
+#include <flow/core/char_window.hpp>
+#include <flow/core/flow_base.hpp>
+#include <flow/core/spin_wait.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace flow {
+
+namespace detail {
+
+// A lock-free ring of fixed-size blocks, passed from a single producer
+// thread to a single consumer thread. The indices only ever increase; the
+// slot for index i is i % num_blocks.
+struct block_ring {
+
+    block_ring(std::size_t block_size, std::size_t num_blocks)
+        : block_size_(block_size),
+          storage_(block_size * num_blocks),
+          lengths_(num_blocks)
+    {}
+
+    [[nodiscard]] auto block_size() const -> std::size_t { return block_size_; }
+
+    // Producer: returns the next free block, or nullptr if stop() was called
+    auto acquire_free() -> char*
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        wait_.wait_until([&] {
+            return tail - head_.load(std::memory_order_acquire) < lengths_.size() ||
+                   stopped_.load(std::memory_order_relaxed);
+        });
+        if (stopped_.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return slot(tail);
+    }
+
+    // Producer: hands the block returned by acquire_free() to the consumer
+    void publish(std::size_t len)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        lengths_[tail % lengths_.size()] = len;
+        tail_.store(tail + 1, std::memory_order_release);
+        wait_.notify_all();
+    }
+
+    // Producer: signals that no more blocks will be published
+    void finish(int error)
+    {
+        error_.store(error, std::memory_order_relaxed);
+        finished_.store(true, std::memory_order_release);
+        wait_.notify_all();
+    }
+
+    // Consumer: waits for the next filled block, returning an empty
+    // maybe once the producer has finished
+    auto acquire_filled() -> maybe<std::string_view>
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        bool available = false;
+        wait_.wait_until([&] {
+            // Check finished_ first, so that a block published just before
+            // finishing is not missed
+            const bool finished = finished_.load(std::memory_order_acquire);
+            available = tail_.load(std::memory_order_acquire) != head;
+            return available || finished;
+        });
+        if (!available) {
+            return {};
+        }
+        return std::string_view(slot(head), lengths_[head % lengths_.size()]);
+    }
+
+    // Consumer: returns the block from acquire_filled() to the producer
+    void release()
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+        wait_.notify_all();
+    }
+
+    // Consumer: asks the producer to give up
+    void stop()
+    {
+        stopped_.store(true, std::memory_order_relaxed);
+        wait_.notify_all();
+    }
+
+    [[nodiscard]] auto error() const -> int
+    {
+        return error_.load(std::memory_order_relaxed);
+    }
+
+private:
+    auto slot(std::size_t idx) -> char*
+    {
+        return storage_.data() + (idx % lengths_.size()) * block_size_;
+    }
+
+    std::size_t block_size_;
+    std::vector<char> storage_;
+    std::vector<std::size_t> lengths_;
+    // Keep the indices on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> stopped_{false};
+    std::atomic<int> error_{0};
+    wait_point wait_;
+};
+
+// Fills blocks from `fd` with pread() until end of file, an error, or
+// the consumer stops the ring
+inline void prefetch_blocks(block_ring& ring, int fd)
+{
+    off_t offset = 0;
+    while (char* block = ring.acquire_free()) {
+        std::size_t len = 0;
+        while (len < ring.block_size()) {
+            const auto n = ::pread(fd, block + len, ring.block_size() - len, offset);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ring.finish(errno);
+                return;
+            }
+            if (n == 0) {
+                break;
+            }
+            len += static_cast<std::size_t>(n);
+            offset += n;
+        }
+        if (len > 0) {
+            ring.publish(len);
+        }
+        if (len < ring.block_size()) {
+            break;
+        }
+    }
+    ring.finish(0);
+}
+
+template <typename, typename = void>
+inline constexpr bool has_error_member = false;
+
+template <typename F>
+inline constexpr bool has_error_member<
+    F, std::void_t<decltype(int(std::declval<F const&>().error()))>> = true;
+
+// Copies the chunks yielded by `flow` into blocks, publishing each block
+// once it is full
+template <typename Flow>
+void prefetch_chunks(block_ring& ring, Flow& flow)
+{
+    char* block = nullptr;
+    std::size_t len = 0;
+
+    while (auto m = flow.next()) {
+        std::string_view chunk(*m);
+        while (!chunk.empty()) {
+            if (!block) {
+                block = ring.acquire_free();
+                if (!block) {
+                    return;
+                }
+                len = 0;
+            }
+            const std::size_t n = detail::min(chunk.size(), ring.block_size() - len);
+            std::memcpy(block + len, chunk.data(), n);
+            len += n;
+            chunk.remove_prefix(n);
+            if (len == ring.block_size()) {
+                ring.publish(len);
+                block = nullptr;
+            }
+        }
+    }
+
+    if (block) {
+        ring.publish(len);
+    }
+    if constexpr (has_error_member<Flow>) {
+        ring.finish(flow.error());
+    } else {
+        ring.finish(0);
+    }
+}
+
+struct prefetch_flow : flow_base<prefetch_flow> {
+
+    // Runs `producer(ring)` on a background thread
+    template <typename Producer>
+    prefetch_flow(std::size_t block_size, std::size_t num_blocks, Producer producer)
+        : state_(std::make_unique<state>(block_size, num_blocks))
+    {
+        state_->reader = std::thread(
+            [&ring = state_->ring, producer = std::move(producer)]() mutable {
+                producer(ring);
+            });
+    }
+
+    prefetch_flow(prefetch_flow&&) noexcept = default;
+    prefetch_flow& operator=(prefetch_flow&&) noexcept = default;
+
+    auto next() -> maybe<std::string_view>
+    {
+        if (holding_) {
+            state_->ring.release();
+        }
+        auto m = state_->ring.acquire_filled();
+        holding_ = static_cast<bool>(m);
+        return m;
+    }
+
+    /// Returns the error code of the failure which ended the flow early,
+    /// or zero. Only meaningful once `next()` has returned an empty `maybe`.
+    [[nodiscard]] auto error() const -> int
+    {
+        return state_->ring.error();
+    }
+
+private:
+    struct state {
+        state(std::size_t block_size, std::size_t num_blocks)
+            : ring(block_size, num_blocks)
+        {}
+
+        ~state()
+        {
+            ring.stop();
+            if (reader.joinable()) {
+                reader.join();
+            }
+        }
+
+        block_ring ring;
+        std::thread reader;
+    };
+
+    // The ring must stay put while the reader thread refers to it
+    std::unique_ptr<state> state_;
+    bool holding_ = false;
+};
+
+inline constexpr std::size_t default_prefetch_block_size = 256 * 1024;
+inline constexpr std::size_t default_prefetch_num_blocks = 4;
+
+struct from_file_prefetched_fn {
+
+    auto operator()(int fd,
+                    std::size_t block_size = default_prefetch_block_size,
+                    std::size_t num_blocks = default_prefetch_num_blocks) const
+    {
+        return open(fd, false, fd < 0 ? EBADF : 0, block_size, num_blocks);
+    }
+
+    auto operator()(const char* path,
+                    std::size_t block_size = default_prefetch_block_size,
+                    std::size_t num_blocks = default_prefetch_num_blocks) const
+    {
+        const int fd = ::open(path, O_RDONLY);
+        return open(fd, true, fd < 0 ? errno : 0, block_size, num_blocks);
+    }
+
+    auto operator()(std::string const& path,
+                    std::size_t block_size = default_prefetch_block_size,
+                    std::size_t num_blocks = default_prefetch_num_blocks) const
+    {
+        return (*this)(path.c_str(), block_size, num_blocks);
+    }
+
+private:
+    // If `fd` is negative, `open_error` is the reason
+    static auto open(int fd, bool owns_fd, int open_error,
+                     std::size_t block_size, std::size_t num_blocks) -> prefetch_flow
+    {
+        assert(block_size > 0 && num_blocks > 1);
+        return prefetch_flow(block_size, num_blocks,
+            [fd, owns_fd, open_error](block_ring& ring) {
+                if (fd < 0) {
+                    ring.finish(open_error);
+                    return;
+                }
+                prefetch_blocks(ring, fd);
+                if (owns_fd) {
+                    ::close(fd);
+                }
+            });
+    }
+};
+
+struct read_ahead_fn {
+    template <typename Flow>
+    auto operator()(Flow flow,
+                    std::size_t block_size = default_prefetch_block_size,
+                    std::size_t num_blocks = default_prefetch_num_blocks) const
+        -> prefetch_flow
+    {
+        static_assert(is_chunk_flow<Flow>,
+                      "Argument to flow::read_ahead() must be a flow whose items "
+                      "are convertible to std::string_view");
+        assert(block_size > 0 && num_blocks > 1);
+        return prefetch_flow(block_size, num_blocks,
+            [flow = std::move(flow)](block_ring& ring) mutable {
+                prefetch_chunks(ring, flow);
+            });
+    }
+};
+
+} // namespace detail
+
+/// Returns a single-pass flow over the contents of a file, read ahead of the
+/// consumer by a background thread.
+///
+/// The file is read with `pread()` in blocks of `block_size` bytes, up to
+/// `num_blocks - 1` of which may be filled while the consumer is still
+/// processing the current one. Blocks are passed between the threads
+/// through a lock-free ring buffer, so parsing overlaps with I/O.
+///
+/// Each item is a `std::string_view` over one block, which is valid only
+/// until the next call to `next()`. Use `flatten()` to obtain a flow of
+/// characters, or pass the flow to `from_lines()` or `from_chars()`.
+///
+/// The source may be a path, in which case the file is opened and closed
+/// by the flow, or an open file descriptor, which is not closed. If
+/// opening or reading the file fails, the flow ends early and its
+/// `error()` member function returns the `errno` value.
+///
+/// @note The background thread requires linking with the platform's
+/// threading library.
+inline constexpr auto from_file_prefetched = detail::from_file_prefetched_fn{};
+
+/// Runs `flow`, whose items are chunks of characters, on a background thread,
+/// returning a single-pass flow over the same characters.
+///
+/// This is useful when producing the chunks is expensive: for example, with
+/// `read_ahead(from_gzip(file))` decompression runs in parallel with
+/// whatever consumes the decompressed text.
+///
+/// The characters are copied into blocks of `block_size` bytes, up to
+/// `num_blocks - 1` of which may be filled ahead of the consumer. Each item
+/// is a `std::string_view` over one block, which is valid only until the
+/// next call to `next()`. If `flow` has an `error()` member function, its
+/// result is available from the returned flow's `error()` once the flow
+/// has ended.
+///
+/// @note The background thread requires linking with the platform's
+/// threading library.
+inline constexpr auto read_ahead = detail::read_ahead_fn{};
+
+}
+
+#endif // FLOW_HAVE_POSIX_IO
+
+#endif
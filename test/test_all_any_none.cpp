@@ -156,6 +156,38 @@ constexpr bool test_any()
 }
 static_assert(test_any());
 
+// Built-in predicates over contiguous arithmetic data take a batched path
+constexpr bool test_batched_all()
+{
+    std::array<int, 150> arr{};
+    for (int i = 0; i < 150; i++) {
+        arr[i] = i + 1;
+    }
+
+    if (not flow::all(arr, flow::pred::positive)) {
+        return false;
+    }
+    if (not flow::none(arr, flow::pred::negative || flow::pred::eq(0))) {
+        return false;
+    }
+    if (not flow::any(arr, flow::pred::eq(150))) {
+        return false;
+    }
+
+    // all() stops immediately after the first failing item, even when it
+    // is part-way through a batch
+    auto f = flow::from(arr);
+    if (f.all(flow::pred::lt(100))) {
+        return false;
+    }
+    if (f.next().value_or(0) != 101) {
+        return false;
+    }
+
+    return true;
+}
+static_assert(test_batched_all());
+
 TEST_CASE("any()", "[flow.any]")
 {
     REQUIRE_FALSE(flow::empty<int>().any(flow::pred::positive));
@@ -173,5 +205,20 @@ TEST_CASE("any()", "[flow.any]")
     REQUIRE_FALSE(flow::any("abcdef"s, is_upper));
 }
 
+TEST_CASE("all() (batched)", "[flow.all]")
+{
+    REQUIRE(test_batched_all());
+
+    std::vector<int> vec(1000, 2);
+    REQUIRE(flow::all(vec, flow::pred::even));
+    vec[777] = 3;
+    REQUIRE_FALSE(flow::all(vec, flow::pred::even));
+    REQUIRE(flow::any(vec, flow::pred::odd));
+
+    auto f = flow::from(vec);
+    REQUIRE(f.any(flow::pred::odd));
+    REQUIRE(f.count() == 222);
+}
+
 
 }
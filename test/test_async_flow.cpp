@@ -0,0 +1,222 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#ifdef FLOW_HAVE_COROUTINES
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if __has_include(<sys/epoll.h>)
+#include <sys/epoll.h>
+#include <unistd.h>
+#define HAVE_EPOLL
+#endif
+
+namespace {
+
+namespace coro = flow::detail::coro_ns;
+
+// A trivial awaitable which records the suspended coroutine, so that tests
+// can resume it later, as an event loop would
+struct manual_event {
+    coro::coroutine_handle<> waiter;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(coro::coroutine_handle<> h) noexcept { waiter = h; }
+    void await_resume() const noexcept {}
+
+    void fire() { std::exchange(waiter, nullptr).resume(); }
+};
+
+auto count_to(int n) -> flow::async_flow<int>
+{
+    for (int i = 1; i <= n; i++) {
+        co_yield i;
+    }
+}
+
+auto wait_then_yield(manual_event& ev, int n) -> flow::async_flow<int>
+{
+    for (int i = 0; i < n; i++) {
+        co_await ev;
+        co_yield i;
+    }
+}
+
+auto throw_after(int n) -> flow::async_flow<int>
+{
+    for (int i = 0; i < n; i++) {
+        co_yield i;
+    }
+    throw std::runtime_error("oops");
+}
+
+template <typename R>
+auto run(flow::async_task<R> task) -> R
+{
+    task.start();
+    REQUIRE(task.done());
+    return task.result();
+}
+
+TEST_CASE("async_flow adaptors", "[flow.async_flow]")
+{
+    auto vec = run(count_to(20)
+                       .filter(flow::pred::even)
+                       .map([](int i) { return std::to_string(i); })
+                       .take(4)
+                       .to_vector());
+    REQUIRE(vec == std::vector<std::string>{"2", "4", "6", "8"});
+
+    auto chunks = run(count_to(7).chunk(3).to_vector());
+    REQUIRE(chunks == std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}, {7}});
+
+    int sum = 0;
+    run(count_to(4).for_each([&sum](int i) { sum += i; }));
+    REQUIRE(sum == 10);
+}
+
+TEST_CASE("async_flow terminals may be awaited", "[flow.async_flow]")
+{
+    auto outer = [](int n) -> flow::async_task<int> {
+        int a = co_await count_to(n).fold(std::plus<>{}, 0);
+        int b = co_await count_to(n).map([](int i) { return i * i; })
+                                    .fold(std::plus<>{}, 0);
+        co_return a + b;
+    };
+
+    REQUIRE(run(outer(3)) == 6 + 14);
+}
+
+TEST_CASE("async_flow suspends until resumed", "[flow.async_flow]")
+{
+    manual_event ev;
+    auto task = wait_then_yield(ev, 3).map([](int i) { return i * 10; }).to_vector();
+
+    task.start();
+    for (int i = 0; i < 3; i++) {
+        REQUIRE_FALSE(task.done());
+        REQUIRE(ev.waiter);
+        ev.fire();
+    }
+    REQUIRE(task.done());
+    REQUIRE(task.result() == std::vector{0, 10, 20});
+}
+
+TEST_CASE("async_flow forwards exceptions", "[flow.async_flow]")
+{
+    int seen = 0;
+    auto task = throw_after(3).for_each([&seen](int) { ++seen; });
+    task.start();
+    REQUIRE(task.done());
+    REQUIRE_THROWS_AS(task.result(), std::runtime_error);
+    REQUIRE(seen == 3);
+}
+
+#ifdef HAVE_EPOLL
+
+// A minimal single-threaded epoll event loop
+struct epoll_loop {
+    epoll_loop() : fd_(::epoll_create1(0)) {}
+    ~epoll_loop() { ::close(fd_); }
+
+    struct readable {
+        epoll_loop& loop;
+        int fd;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(coro::coroutine_handle<> h)
+        {
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLONESHOT;
+            ev.data.ptr = h.address();
+            if (::epoll_ctl(loop.fd_, EPOLL_CTL_MOD, fd, &ev) != 0) {
+                ::epoll_ctl(loop.fd_, EPOLL_CTL_ADD, fd, &ev);
+            }
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    void run_until(std::function<bool()> done)
+    {
+        epoll_event events[64];
+        while (!done()) {
+            const int n = ::epoll_wait(fd_, events, 64, 1000);
+            REQUIRE(n > 0);
+            for (int i = 0; i < n; i++) {
+                coro::coroutine_handle<>::from_address(events[i].data.ptr).resume();
+            }
+        }
+    }
+
+private:
+    int fd_;
+};
+
+// Yields the bytes read from `fd` as integers, until end of file
+auto read_bytes(epoll_loop& loop, int fd) -> flow::async_flow<int>
+{
+    char buf[16];
+    while (true) {
+        co_await epoll_loop::readable{loop, fd};
+        const auto n = ::read(fd, buf, sizeof(buf));
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            co_yield static_cast<int>(buf[i]);
+        }
+    }
+}
+
+TEST_CASE("async_flow multiplexes many streams on one thread", "[flow.async_flow]")
+{
+    constexpr int num_streams = 100;
+    epoll_loop loop;
+
+    std::vector<int> write_fds;
+    std::vector<flow::async_task<int>> tasks;
+    for (int i = 0; i < num_streams; i++) {
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+        write_fds.push_back(fds[1]);
+        tasks.push_back(read_bytes(loop, fds[0]).fold(std::plus<>{}, 0));
+        tasks.back().start();
+        // Each task is now waiting for its pipe to become readable
+        REQUIRE_FALSE(tasks.back().done());
+    }
+
+    // Feed the streams in interleaved rounds
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < num_streams; i++) {
+            const char c = static_cast<char>(i % 10 + round);
+            REQUIRE(::write(write_fds[i], &c, 1) == 1);
+        }
+    }
+    for (int fd : write_fds) {
+        ::close(fd);
+    }
+
+    loop.run_until([&] {
+        return flow::all(tasks, [](auto const& t) { return t.done(); });
+    });
+
+    for (int i = 0; i < num_streams; i++) {
+        REQUIRE(tasks[i].result() == 3 * (i % 10) + 3);
+    }
+}
+
+#endif // HAVE_EPOLL
+
+}
+
+#endif // FLOW_HAVE_COROUTINES
@@ -0,0 +1,145 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <flow.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr bool test_cartesian_product_tiled_order()
+{
+    std::array a{0, 1, 2, 3};
+    std::array b{0, 1, 2};
+
+    auto prod = flow::cartesian_product_tiled_with(
+        [](auto i, auto j) { return 10 * i + j; }, a, b, 2);
+
+    static_assert(std::is_same_v<flow::item_t<decltype(prod)>, int>);
+    static_assert(flow::is_sized_flow<decltype(prod)>);
+
+    if (prod.size() != 12) {
+        return false;
+    }
+
+    const auto required = std::array{
+         0,  1, 10, 11,
+         2, 12,
+        20, 21, 30, 31,
+        22, 32
+    };
+
+    return flow::equal(std::move(prod), required);
+}
+static_assert(test_cartesian_product_tiled_order());
+
+constexpr bool test_cartesian_product_tiled_pairs()
+{
+    std::array a{1, 2};
+    std::array const b{'a', 'b'};
+
+    auto prod = flow::from(a).cartesian_product_tiled(b, 1);
+
+    static_assert(std::is_same_v<flow::item_t<decltype(prod)>, std::pair<int&, char const&>>);
+
+    auto m = prod.next();
+    if (!m || m->first != 1 || m->second != 'a') {
+        return false;
+    }
+    m->first = 10;
+
+    return a[0] == 10 && prod.count() == 3;
+}
+static_assert(test_cartesian_product_tiled_pairs());
+
+constexpr bool test_cartesian_product_tiled_empty()
+{
+    std::array a{1, 2, 3};
+    std::array<int, 0> e{};
+
+    auto sink = [](int, int) { return 0; };
+
+    return flow::cartesian_product_tiled_with(sink, a, e).count() == 0 &&
+           flow::cartesian_product_tiled_with(sink, e, a).count() == 0 &&
+           flow::cartesian_product_tiled_with(sink, e, a).size() == 0 &&
+           !flow::cartesian_product_tiled_with(sink, a, e).next();
+}
+static_assert(test_cartesian_product_tiled_empty());
+
+}
+
+TEST_CASE("cartesian_product_tiled visits every combination once", "[cartesian_product_tiled]")
+{
+    auto a = flow::ints(0, 37).to_vector();
+    auto b = flow::ints(0, 23).to_vector();
+
+    auto expected = flow::cartesian_product_with(
+        [](auto i, auto j) { return 100 * i + j; }, a, b).to_vector();
+
+    for (flow::dist_t tile : {1, 2, 5, 16, 23, 37, 64}) {
+        auto got = flow::cartesian_product_tiled_with(
+            [](auto i, auto j) { return 100 * i + j; }, a, b, tile).to_vector();
+
+        std::sort(got.begin(), got.end());
+        REQUIRE(got == expected);
+    }
+}
+
+TEST_CASE("cartesian_product_tiled resumes after an early exit", "[cartesian_product_tiled]")
+{
+    auto a = flow::ints(0, 9).to_vector();
+    auto b = flow::ints(0, 7).to_vector();
+
+    auto fn = [](auto i, auto j) { return 10 * i + j; };
+
+    auto all = flow::cartesian_product_tiled_with(fn, a, b, 4).to_vector();
+    REQUIRE(all.size() == 63);
+
+    // Mixing next() and try_fold()-based consumers must give the same order
+    auto prod = flow::cartesian_product_tiled_with(fn, a, b, 4);
+    std::vector<flow::dist_t> got;
+    flow::dist_t expected_size = 63;
+
+    while (true) {
+        REQUIRE(prod.size() == expected_size);
+        auto m = prod.next();
+        if (!m) {
+            break;
+        }
+        got.push_back(*m);
+        --expected_size;
+
+        // Take a few more with an early-exiting internal iteration
+        if (auto n = got.size() % 3; n > 0) {
+            (void) prod.try_for_each([&](flow::maybe<flow::dist_t> item) {
+                got.push_back(*item);
+                --expected_size;
+                return --n > 0;
+            });
+        }
+    }
+
+    REQUIRE(got == all);
+}
+
+TEST_CASE("cartesian_product_tiled with mapped flows", "[cartesian_product_tiled]")
+{
+    std::vector<int> a{1, 2, 3};
+    std::vector<int> b{10, 20};
+
+    auto prod = flow::from(a).map([](int i) { return i * i; })
+                    .cartesian_product_tiled(flow::from(b).map([](int j) { return -j; }), 2);
+
+    static_assert(std::is_same_v<flow::item_t<decltype(prod)>, std::pair<int, int>>);
+
+    auto got = std::move(prod).to_vector();
+    std::vector<std::pair<int, int>> expected{
+        {1, -10}, {1, -20}, {4, -10}, {4, -20}, {9, -10}, {9, -20}
+    };
+    REQUIRE(got == expected);
+}
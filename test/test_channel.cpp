@@ -0,0 +1,170 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST_CASE("channel capacity and non-blocking operations", "[flow.channel]")
+{
+    flow::spsc_channel<int> ch(3);
+    REQUIRE(ch.capacity() == 4);
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(ch.try_push(i));
+    }
+    REQUIRE_FALSE(ch.try_push(99));
+
+    REQUIRE(ch.try_pop().value() == 0);
+    REQUIRE(ch.try_push(4));
+
+    std::vector<int> out;
+    REQUIRE(ch.try_pop_batch(std::back_inserter(out), 10) == 4);
+    REQUIRE(out == std::vector{1, 2, 3, 4});
+    REQUIRE_FALSE(ch.try_pop().has_value());
+}
+
+TEST_CASE("MPMC channel non-blocking operations", "[flow.channel]")
+{
+    flow::channel<std::unique_ptr<int>> ch(4);
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(ch.try_push(std::make_unique<int>(i)));
+    }
+    REQUIRE_FALSE(ch.try_push(std::make_unique<int>(99)));
+
+    // Wrap around a few times
+    for (int i = 4; i < 20; i++) {
+        auto m = ch.try_pop();
+        REQUIRE(**m == i - 4);
+        REQUIRE(ch.try_push(std::make_unique<int>(i)));
+    }
+
+    ch.close();
+    REQUIRE_FALSE(ch.push(std::make_unique<int>(99)));
+
+    // Values pushed before closing can still be received
+    auto vals = ch.receiver().map([](auto p) { return *p; }).to_vector();
+    REQUIRE(vals == std::vector{16, 17, 18, 19});
+    REQUIRE_FALSE(ch.pop().has_value());
+}
+
+TEST_CASE("SPSC channel between threads", "[flow.channel]")
+{
+    constexpr int count = 100'000;
+    flow::spsc_channel<int> ch(256);
+
+    std::thread producer([&ch] {
+        ch.push_all(flow::ints(0, count));
+        ch.close();
+    });
+
+    bool in_order = true;
+    int expected = 0;
+    ch.receiver().for_each([&](int i) {
+        in_order = in_order && (i == expected++);
+    });
+    producer.join();
+
+    REQUIRE(in_order);
+    REQUIRE(expected == count);
+}
+
+TEST_CASE("MPMC channel between threads", "[flow.channel]")
+{
+    constexpr int num_producers = 4;
+    constexpr int num_consumers = 3;
+    constexpr long long per_producer = 20'000;
+
+    flow::channel<long long> ch(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; p++) {
+        producers.emplace_back([&ch, p] {
+            if (p % 2 == 0) {
+                ch.push_all(flow::iota(p * per_producer).take(per_producer));
+            } else {
+                flow::iota(p * per_producer)
+                    .take(per_producer)
+                    .output_to(ch.sender());
+            }
+        });
+    }
+
+    std::vector<long long> sums(num_consumers);
+    std::vector<long long> counts(num_consumers);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < num_consumers; c++) {
+        consumers.emplace_back([&, c] {
+            ch.receiver(8).for_each([&](long long i) {
+                sums[c] += i;
+                ++counts[c];
+            });
+        });
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    ch.close();
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    constexpr long long n = num_producers * per_producer;
+    REQUIRE(flow::sum(counts) == n);
+    REQUIRE(flow::sum(sums) == n * (n - 1) / 2);
+}
+
+TEST_CASE("Closing a channel unblocks a waiting producer", "[flow.channel]")
+{
+    flow::channel<std::string> ch(2);
+
+    bool result = true;
+    std::thread producer([&] {
+        result = ch.push_all(flow::of{"a", "b", "c", "d"}.map([](auto s) {
+            return std::string(s);
+        }));
+    });
+
+    REQUIRE(ch.pop().value() == "a");
+    ch.close();
+    producer.join();
+
+    REQUIRE_FALSE(result);
+}
+
+TEST_CASE("A thread waiting on an idle channel does not spin", "[flow.channel]")
+{
+    flow::spsc_channel<int> ch(4);
+
+    const std::clock_t start = std::clock();
+    std::thread consumer([&] {
+        REQUIRE(ch.pop().value() == 1);
+        REQUIRE_FALSE(ch.pop().has_value());
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    ch.push(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    ch.close();
+    consumer.join();
+
+    // std::clock() measures the CPU time of the whole process, which would
+    // be at least 600ms if the consumer had been busy-waiting
+    const double cpu_ms = 1000.0 * double(std::clock() - start) / CLOCKS_PER_SEC;
+    REQUIRE(cpu_ms < 200);
+}
+
+}
@@ -0,0 +1,225 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <flow.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr bool test_pairs()
+{
+    std::array arr{1, 2, 3, 4};
+
+    auto p = flow::pairs(arr);
+
+    static_assert(std::is_same_v<flow::item_t<decltype(p)>, std::pair<int&, int&>>);
+    static_assert(flow::is_random_access_flow<decltype(p)>);
+
+    if (p.size() != 6) {
+        return false;
+    }
+
+    const auto required = std::array<std::pair<int, int>, 6>{{
+        {1, 2}, {1, 3}, {1, 4}, {2, 3}, {2, 4}, {3, 4}
+    }};
+
+    return flow::equal(std::move(p), required, [](auto const& a, auto const& b) {
+        return a.first == b.first && a.second == b.second;
+    });
+}
+static_assert(test_pairs());
+
+constexpr bool test_combinations3()
+{
+    std::array arr{1, 2, 3, 4, 5};
+
+    auto c = flow::from(arr).combinations<3>()
+                 .map([](auto t) {
+                     auto [x, y, z] = t;
+                     return 100 * x + 10 * y + z;
+                 });
+
+    if (c.size() != 10) {
+        return false;
+    }
+
+    const auto required = std::array{
+        123, 124, 125, 134, 135, 145, 234, 235, 245, 345
+    };
+
+    return flow::equal(std::move(c), required);
+}
+static_assert(test_combinations3());
+
+constexpr bool test_permutations2()
+{
+    std::array arr{1, 2, 3};
+
+    auto p = flow::permutations<2>(arr)
+                 .map([](auto t) { return 10 * std::get<0>(t) + std::get<1>(t); });
+
+    if (p.size() != 6) {
+        return false;
+    }
+
+    return flow::equal(std::move(p), std::array{12, 13, 21, 23, 31, 32});
+}
+static_assert(test_permutations2());
+
+constexpr bool test_combinations_empty()
+{
+    std::array arr{1, 2};
+
+    return flow::combinations<3>(arr).size() == 0 &&
+           !flow::combinations<3>(arr).next() &&
+           flow::permutations<3>(arr).count() == 0 &&
+           flow::pairs(std::array<int, 0>{}).count() == 0;
+}
+static_assert(test_combinations_empty());
+
+template <std::size_t K, bool Ordered>
+auto brute_force(int n) -> std::vector<std::vector<int>>
+{
+    std::vector<std::vector<int>> out;
+    if (n == 0) {
+        return out;
+    }
+    std::vector<int> idx(K, 0);
+    while (true) {
+        bool ok = true;
+        for (std::size_t i = 0; i < K; ++i) {
+            for (std::size_t j = i + 1; j < K; ++j) {
+                ok = ok && (Ordered ? idx[i] != idx[j] : idx[i] < idx[j]);
+            }
+        }
+        if (ok) {
+            out.push_back(idx);
+        }
+        std::size_t p = K;
+        while (p > 0 && ++idx[p - 1] == n) {
+            idx[--p] = 0;
+        }
+        if (p == 0) {
+            return out;
+        }
+    }
+}
+
+template <typename Tuple>
+auto to_vec(Tuple const& t) -> std::vector<int>
+{
+    return std::apply([](auto const&... x) { return std::vector<int>{int(x)...}; }, t);
+}
+
+}
+
+TEST_CASE("combinations and permutations match brute force", "[combinations]")
+{
+    for (int n = 0; n < 8; ++n) {
+        auto vec = flow::ints(0, n).map([](auto i) { return int(i); }).to_vector();
+
+        CHECK(flow::combinations<3>(vec).map([](auto const& t) { return to_vec(t); })
+                  .to_vector() == brute_force<3, false>(n));
+        CHECK(flow::permutations<3>(vec).map([](auto const& t) { return to_vec(t); })
+                  .to_vector() == brute_force<3, true>(n));
+        CHECK(flow::pairs(vec).map([](auto const& t) { return to_vec(t); })
+                  .to_vector() == brute_force<2, false>(n));
+
+        // Non-random-access source
+        CHECK(flow::ints(0, n).combinations<3>().map([](auto const& t) { return to_vec(t); })
+                  .to_vector() == brute_force<3, false>(n));
+        CHECK(flow::ints(0, n).permutations<2>().map([](auto const& t) { return to_vec(t); })
+                  .to_vector() == brute_force<2, true>(n));
+    }
+}
+
+TEST_CASE("combinations can be split by position", "[combinations]")
+{
+    auto vec = flow::ints(0, 20).map([](auto i) { return int(i); }).to_vector();
+
+    SECTION("combinations")
+    {
+        auto comb = flow::combinations<4>(vec);
+        auto all = comb.subflow().map([](auto const& t) { return to_vec(t); }).to_vector();
+        REQUIRE(comb.size() == 4845);
+        REQUIRE(static_cast<flow::dist_t>(all.size()) == comb.size());
+
+        // Every selection can be reached directly
+        for (flow::dist_t i = 0; i < comb.size(); i += 7) {
+            auto m = comb.subflow().advance(i + 1);
+            REQUIRE(m.has_value());
+            REQUIRE(to_vec(*m) == all[i]);
+        }
+
+        // Splitting into pieces and processing each separately gives the
+        // same result as processing the whole
+        const flow::dist_t pieces = 6;
+        const flow::dist_t piece_size = comb.size() / pieces + 1;
+        std::vector<std::vector<int>> joined;
+        for (flow::dist_t p = 0; p < pieces; ++p) {
+            auto piece = comb.subflow();
+            if (p > 0) {
+                (void) piece.advance(p * piece_size);
+            }
+            std::move(piece).take(piece_size).for_each([&](auto const& t) {
+                joined.push_back(to_vec(t));
+            });
+        }
+        REQUIRE(joined == all);
+    }
+
+    SECTION("permutations")
+    {
+        auto perm = flow::permutations<3>(vec);
+        auto all = perm.subflow().map([](auto const& t) { return to_vec(t); }).to_vector();
+        REQUIRE(perm.size() == 20 * 19 * 18);
+        REQUIRE(static_cast<flow::dist_t>(all.size()) == perm.size());
+
+        for (flow::dist_t i = 0; i < perm.size(); i += 5) {
+            auto m = perm.subflow().advance(i + 1);
+            REQUIRE(to_vec(*m) == all[i]);
+        }
+    }
+}
+
+TEST_CASE("combinations with early exit", "[combinations]")
+{
+    auto vec = flow::ints(1, 30).map([](auto i) { return int(i); }).to_vector();
+
+    auto comb = flow::combinations<3>(vec);
+
+    auto is_triple = [](auto const& t) {
+        auto [x, y, z] = t;
+        return x * x + y * y == z * z;
+    };
+
+    auto find_triple = [&] {
+        std::vector<int> found;
+        (void) comb.try_for_each([&](auto m) {
+            if (is_triple(*m)) {
+                found = to_vec(*m);
+                return false;
+            }
+            return true;
+        });
+        return found;
+    };
+
+    REQUIRE(find_triple() == std::vector{3, 4, 5});
+    const auto remaining = comb.size();
+
+    // The search stopped immediately after the match, so we can carry on
+    REQUIRE(find_triple() == std::vector{5, 12, 13});
+    REQUIRE(find_triple() == std::vector{6, 8, 10});
+    REQUIRE(comb.size() < remaining);
+
+    auto as_vec = [](auto const& t) { return to_vec(t); };
+    auto rest = flow::combinations<3>(vec).filter(is_triple).drop(3).map(as_vec).to_vector();
+    REQUIRE(std::move(comb).filter(is_triple).map(as_vec).to_vector() == rest);
+}
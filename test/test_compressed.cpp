@@ -0,0 +1,217 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#if defined(FLOW_HAVE_ZLIB) || defined(FLOW_HAVE_ZSTD)
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+#ifdef FLOW_HAVE_ZLIB
+// Compresses `data` as a single gzip member
+auto gzip(std::string const& data) -> std::string
+{
+    z_stream strm{};
+    REQUIRE(deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                         Z_DEFAULT_STRATEGY) == Z_OK);
+
+    std::string out(deflateBound(&strm, static_cast<uLong>(data.size())), '\0');
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    strm.avail_in = static_cast<uInt>(data.size());
+    strm.next_out = reinterpret_cast<Bytef*>(out.data());
+    strm.avail_out = static_cast<uInt>(out.size());
+    REQUIRE(deflate(&strm, Z_FINISH) == Z_STREAM_END);
+    out.resize(strm.total_out);
+    deflateEnd(&strm);
+    return out;
+}
+#endif
+
+#ifdef FLOW_HAVE_ZSTD
+// Compresses `data` as a single Zstandard frame
+auto zstd(std::string const& data) -> std::string
+{
+    std::string out(ZSTD_compressBound(data.size()), '\0');
+    const std::size_t n = ZSTD_compress(out.data(), out.size(), data.data(), data.size(), 3);
+    REQUIRE(!ZSTD_isError(n));
+    out.resize(n);
+    return out;
+}
+#endif
+
+auto make_lines(int n) -> std::string
+{
+    std::string out;
+    for (int i = 0; i < n; i++) {
+        out += "line number " + std::to_string(i) + '\n';
+    }
+    return out;
+}
+
+auto to_string = [](auto&& flow) {
+    std::string out;
+    FLOW_FWD(flow).for_each([&out](std::string_view chunk) { out += chunk; });
+    return out;
+};
+
+}
+
+#ifdef FLOW_HAVE_ZLIB
+
+TEST_CASE("from_gzip()", "[flow.compressed]")
+{
+    const std::string text = make_lines(50'000);
+    const std::string compressed = gzip(text);
+    REQUIRE(compressed.size() < text.size());
+
+    SECTION("from a string") {
+        CHECK(to_string(flow::from_gzip(std::string_view(compressed))) == text);
+    }
+
+    SECTION("from a stream") {
+        std::istringstream is(compressed);
+        auto f = flow::from_gzip(is);
+        CHECK(to_string(std::move(f)) == text);
+    }
+
+    SECTION("as characters") {
+        auto n = flow::from_gzip(std::string_view(compressed)).flatten().count('\n');
+        CHECK(n == 50'000);
+    }
+
+    SECTION("as lines") {
+        auto lines = flow::from_lines(flow::from_gzip(std::string_view(compressed)));
+        CHECK(lines.next().value() == "line number 0");
+        CHECK(std::move(lines).count() == 49'999);
+    }
+
+#ifdef FLOW_HAVE_POSIX_IO
+    SECTION("on a separate thread") {
+        auto f = flow::read_ahead(flow::from_gzip(std::string_view(compressed)), 4096);
+        CHECK(to_string(std::move(f)) == text);
+    }
+#endif
+
+    SECTION("concatenated members") {
+        const std::string two = gzip("hello ") + gzip("world");
+        CHECK(to_string(flow::from_gzip(std::string_view(two))) == "hello world");
+    }
+
+    SECTION("empty input") {
+        auto f = flow::from_gzip(std::string_view());
+        CHECK(!f.next().has_value());
+        CHECK(f.error() == 0);
+    }
+}
+
+TEST_CASE("from_gzip() errors", "[flow.compressed]")
+{
+    const std::string compressed = gzip(make_lines(1000));
+
+    SECTION("truncated input") {
+        auto f = flow::from_gzip(std::string_view(compressed).substr(0, compressed.size() / 2));
+        while (f.next()) {}
+        CHECK(f.error() == Z_BUF_ERROR);
+    }
+
+    SECTION("corrupt input") {
+        auto f = flow::from_gzip(std::string_view("this is not gzip data"));
+        CHECK(!f.next().has_value());
+        CHECK(f.error() == Z_DATA_ERROR);
+    }
+
+#ifdef FLOW_HAVE_POSIX_IO
+    SECTION("errors are passed through read_ahead()") {
+        auto f = flow::read_ahead(flow::from_gzip(std::string_view("not gzip")));
+        CHECK(!f.next().has_value());
+        CHECK(f.error() == Z_DATA_ERROR);
+    }
+#endif
+}
+
+#endif // FLOW_HAVE_ZLIB
+
+#ifdef FLOW_HAVE_ZSTD
+
+TEST_CASE("from_zstd()", "[flow.compressed]")
+{
+    const std::string text = make_lines(50'000);
+    const std::string compressed = zstd(text);
+    REQUIRE(compressed.size() < text.size());
+
+    SECTION("from a string") {
+        CHECK(to_string(flow::from_zstd(std::string_view(compressed))) == text);
+    }
+
+    SECTION("from a stream") {
+        std::istringstream is(compressed);
+        auto f = flow::from_zstd(is);
+        CHECK(to_string(std::move(f)) == text);
+    }
+
+    SECTION("as characters") {
+        auto n = flow::from_zstd(std::string_view(compressed)).flatten().count('\n');
+        CHECK(n == 50'000);
+    }
+
+    SECTION("as lines") {
+        auto lines = flow::from_lines(flow::from_zstd(std::string_view(compressed)));
+        CHECK(lines.next().value() == "line number 0");
+        CHECK(std::move(lines).count() == 49'999);
+    }
+
+#ifdef FLOW_HAVE_POSIX_IO
+    SECTION("on a separate thread") {
+        auto f = flow::read_ahead(flow::from_zstd(std::string_view(compressed)), 4096);
+        CHECK(to_string(std::move(f)) == text);
+    }
+#endif
+
+    SECTION("concatenated frames") {
+        const std::string two = zstd("hello ") + zstd("world");
+        CHECK(to_string(flow::from_zstd(std::string_view(two))) == "hello world");
+    }
+
+    SECTION("empty input") {
+        auto f = flow::from_zstd(std::string_view());
+        CHECK(!f.next().has_value());
+        CHECK(f.error() == 0);
+    }
+}
+
+TEST_CASE("from_zstd() errors", "[flow.compressed]")
+{
+    const std::string compressed = zstd(make_lines(1000));
+
+    SECTION("truncated input") {
+        auto f = flow::from_zstd(std::string_view(compressed).substr(0, compressed.size() / 2));
+        while (f.next()) {}
+        CHECK(f.error() == ZSTD_error_srcSize_wrong);
+    }
+
+    SECTION("corrupt input") {
+        auto f = flow::from_zstd(std::string_view("this is not zstd data"));
+        CHECK(!f.next().has_value());
+        CHECK(f.error() == ZSTD_error_prefix_unknown);
+    }
+
+#ifdef FLOW_HAVE_POSIX_IO
+    SECTION("errors are passed through read_ahead()") {
+        auto f = flow::read_ahead(flow::from_zstd(std::string_view("not zstd")));
+        CHECK(!f.next().has_value());
+        CHECK(f.error() == ZSTD_error_prefix_unknown);
+    }
+#endif
+}
+
+#endif // FLOW_HAVE_ZSTD
+
+#endif
@@ -38,6 +38,33 @@ constexpr bool test_nonmember_count_if()
 }
 static_assert(test_nonmember_count_if());
 
+// Built-in predicates over contiguous arithmetic data take a batched path
+constexpr bool test_batched_count_if()
+{
+    std::array<int, 200> arr{};
+    for (int i = 0; i < 200; i++) {
+        arr[i] = i;
+    }
+
+    if (flow::count_if(arr, flow::pred::even) != 100) {
+        return false;
+    }
+
+    if (flow::from(arr).count_if(flow::pred::in(3, 5, 150, 1000)) != 3) {
+        return false;
+    }
+
+    // The flow is exhausted afterwards
+    auto f = flow::from(arr);
+    (void) f.count_if(flow::pred::lt(10));
+    if (f.next().has_value()) {
+        return false;
+    }
+
+    return flow::of{1, 2, 3, 4}.count_if(flow::pred::gt(1) && flow::pred::lt(4)) == 2;
+}
+static_assert(test_batched_count_if());
+
 TEST_CASE("Member count_if()", "[flow.count_if]")
 {
     REQUIRE(test_member_count_if());
@@ -48,4 +75,16 @@ TEST_CASE("Non-member count_if()", "[flow.count_if]")
     REQUIRE(test_nonmember_count_if());
 }
 
+TEST_CASE("Batched count_if()", "[flow.count_if]")
+{
+    REQUIRE(test_batched_count_if());
+
+    std::vector<double> vec(10'000);
+    for (std::size_t i = 0; i < vec.size(); i++) {
+        vec[i] = static_cast<double>(i) - 5000.0;
+    }
+    REQUIRE(flow::count_if(vec, flow::pred::negative) == 5000);
+    REQUIRE(flow::count_if(vec, flow::pred::nonzero) == 9999);
+}
+
 }
@@ -0,0 +1,107 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr bool test_dedup()
+{
+    // Basic dedup
+    {
+        auto f = flow::of{1, 1, 2, 3, 3, 3, 1, 4, 4}.dedup();
+
+        static_assert(flow::is_flow<decltype(f)>);
+        static_assert(not flow::is_sized_flow<decltype(f)>);
+
+        if (not f.equal(flow::of{1, 2, 3, 1, 4})) {
+            return false;
+        }
+    }
+
+    // Dedup of an empty flow is empty
+    {
+        auto f = flow::empty<int>().dedup();
+        if (f.next().has_value()) {
+            return false;
+        }
+    }
+
+    // Dedup with a key function
+    {
+        auto f = flow::ints(0, 10).dedup([](int i) { return i / 3; });
+
+        if (not f.equal(flow::of{0, 3, 6, 9})) {
+            return false;
+        }
+    }
+
+    // Dedup of prvalue items
+    {
+        auto f = flow::ints(0, 10).map([](int i) { return i / 2; }).dedup();
+
+        if (not f.equal(flow::ints(0, 5))) {
+            return false;
+        }
+    }
+
+    // We can take subflows, which remember the last item
+    {
+        auto f = flow::of{1, 1, 2, 2, 3}.dedup();
+        (void) f.next();
+
+        if (not f.subflow().equal(flow::of{2, 3})) {
+            return false;
+        }
+        if (not f.equal(flow::of{2, 3})) {
+            return false;
+        }
+    }
+
+    // Free function version
+    {
+        std::array arr{1, 2, 2, 2, 3};
+
+        if (not flow::dedup(arr).equal(flow::of{1, 2, 3})) {
+            return false;
+        }
+    }
+
+    return true;
+}
+static_assert(test_dedup());
+
+TEST_CASE("dedup", "[flow.dedup]")
+{
+    REQUIRE(test_dedup());
+}
+
+TEST_CASE("dedup (prvalue strings)", "[flow.dedup]")
+{
+    std::vector<std::string> vec{"a", "a", "b", "a", "c", "c"};
+
+    auto out = flow::from(vec).map([](std::string const& s) { return s; })
+                   .dedup().to_vector();
+
+    REQUIRE((out == std::vector<std::string>{"a", "b", "a", "c"}));
+}
+
+TEST_CASE("dedup (by member)", "[flow.dedup]")
+{
+    std::vector<std::pair<int, char>> vec{{1, 'a'}, {1, 'b'}, {2, 'c'}, {1, 'd'}};
+
+    auto out = flow::dedup(vec, &std::pair<int, char>::first)
+                   .map(&std::pair<int, char>::second).to_string();
+
+    REQUIRE(out == "acd");
+}
+
+}
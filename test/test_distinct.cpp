@@ -0,0 +1,82 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+TEST_CASE("distinct", "[flow.distinct]")
+{
+    auto out = flow::of{3, 1, 3, 2, 1, 4, 2}.distinct().to_vector();
+
+    REQUIRE((out == std::vector<int>{3, 1, 2, 4}));
+}
+
+TEST_CASE("distinct (empty flow)", "[flow.distinct]")
+{
+    REQUIRE(flow::empty<int>().distinct().count() == 0);
+}
+
+TEST_CASE("distinct (key function)", "[flow.distinct]")
+{
+    auto out = flow::iota(0, 20).distinct([](int i) { return i % 7; }).to_vector();
+
+    REQUIRE((out == std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST_CASE("distinct (strings)", "[flow.distinct]")
+{
+    std::vector<std::string> vec{"b", "a", "b", "c", "a", "d"};
+
+    auto out = flow::distinct(vec).to_vector();
+
+    REQUIRE((out == std::vector<std::string>{"b", "a", "c", "d"}));
+}
+
+TEST_CASE("distinct (many items)", "[flow.distinct]")
+{
+    // Enough items to force the hash set to grow several times
+    auto f = flow::ints(0, 100'000).map([](int i) { return i % 10'007; }).distinct();
+
+    REQUIRE(f.sum() == 10'006 * 10'007 / 2);
+}
+
+TEST_CASE("distinct_approx", "[flow.distinct]")
+{
+    // Never yields a duplicate
+    {
+        auto out = flow::ints(0, 10'000)
+                       .map([](int i) { return i % 100; })
+                       .distinct_approx(1024)
+                       .to_vector();
+
+        auto sorted = out;
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+        // With 8192 bits for 100 keys, false positives are vanishingly rare
+        REQUIRE(out.size() == 100);
+    }
+
+    // Works on an infinite flow in fixed memory
+    {
+        auto n = flow::ints().map([](int i) { return i % 50; })
+                     .distinct_approx(4096)
+                     .take(50)
+                     .count();
+        REQUIRE(n == 50);
+    }
+
+    // With a key function
+    {
+        auto out = flow::distinct_approx(std::vector{10, 11, 20, 21, 30}, 1024,
+                                         [](int i) { return i / 10; })
+                       .to_vector();
+        REQUIRE((out == std::vector<int>{10, 20, 30}));
+    }
+}
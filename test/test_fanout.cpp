@@ -0,0 +1,100 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr bool test_fanout()
+{
+    int arr[] = {3, 1, 4, 1, 5, 9, 2, 6};
+
+    auto [sum, count, evens, mm] = flow::fanout(arr,
+        flow::sink::sum(),
+        flow::sink::count(),
+        flow::sink::count_if(flow::pred::even),
+        flow::sink::minmax());
+
+    return sum == 31 && count == 8 && evens == 3 &&
+           mm->min == 1 && mm->max == 9;
+}
+static_assert(test_fanout());
+
+constexpr bool test_fanout_composition()
+{
+    int arr[] = {1, 2, 3, 4, 5, 6};
+
+    auto [odd_sum, squares] = flow::from(arr).fanout(
+        flow::sink::filter(flow::pred::odd, flow::sink::sum()),
+        flow::sink::map([](int i) { return i * i; },
+                        flow::sink::fanout(flow::sink::max(),
+                                           flow::sink::fold(std::plus<>{}, 0))));
+
+    auto [max_sq, sum_sq] = squares;
+    return odd_sum == 9 && *max_sq == 36 && sum_sq == 91;
+}
+static_assert(test_fanout_composition());
+
+TEST_CASE("fanout() with an empty flow", "[flow.fanout]")
+{
+    auto [mn, mx, mm, n, vec] = flow::empty<int>().fanout(
+        flow::sink::min(), flow::sink::max(), flow::sink::minmax(),
+        flow::sink::count(), flow::sink::to_vector());
+
+    REQUIRE_FALSE(mn.has_value());
+    REQUIRE_FALSE(mx.has_value());
+    REQUIRE_FALSE(mm.has_value());
+    REQUIRE(n == 0);
+    REQUIRE(vec.empty());
+}
+
+TEST_CASE("fanout() matches the individual terminals", "[flow.fanout]")
+{
+    const std::vector<std::string> strs{"pear", "apple", "fig", "kiwi", "plum"};
+    const auto by_size = [](auto const& a, auto const& b) {
+        return a.size() < b.size();
+    };
+
+    std::vector<std::string> copied;
+    auto [shortest, longest, vec, total_len, iter] = flow::from(strs).fanout(
+        flow::sink::min(by_size),
+        flow::sink::max(by_size),
+        flow::sink::to_vector(),
+        flow::sink::map([](auto const& s) { return s.size(); }, flow::sink::sum()),
+        flow::sink::output_to(std::back_inserter(copied)));
+
+    REQUIRE(shortest.value() == flow::min(strs, by_size).value());
+    REQUIRE(longest.value() == flow::max(strs, by_size).value());
+    REQUIRE(vec == strs);
+    REQUIRE(copied == strs);
+    REQUIRE(total_len == 20);
+    (void) iter;
+}
+
+TEST_CASE("fanout() visits each item once", "[flow.fanout]")
+{
+    int calls = 0;
+    auto [n, v] = flow::ints(0, 100)
+                      .map([&calls](int i) { ++calls; return i; })
+                      .fanout(flow::sink::count(), flow::sink::to_vector<long>());
+
+    REQUIRE(calls == 100);
+    REQUIRE(n == 100);
+    REQUIRE(v.size() == 100);
+    REQUIRE(v.back() == 99L);
+
+    int seen = 0;
+    auto [f] = flow::fanout(std::vector{1, 2, 3},
+                            flow::sink::for_each([&seen](int i) { seen += i; }));
+    (void) f;
+    REQUIRE(seen == 6);
+}
+
+}
@@ -120,4 +120,62 @@ TEST_CASE("flat map", "[flow.flat_map]")
     REQUIRE(test_flat_map());
 }
 
+constexpr bool test_flatten_try_fold()
+{
+    std::array<std::array<int, 3>, 3> arrs{{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}}};
+
+    auto f = flow::flatten(arrs);
+
+    // Stop part-way through the second inner range
+    int seen = 0;
+    (void) f.try_for_each([&seen](auto m) { return ++seen < 5 && *m != 0; });
+
+    if (f.next().value() != 6) {
+        return false;
+    }
+
+    return f.sum() == 7 + 8 + 9;
+}
+static_assert(test_flatten_try_fold());
+
+TEST_CASE("flatten try_fold() resumes inside an inner range", "[flow.flatten]")
+{
+    std::vector<std::vector<int>> vecs{{1, 2}, {}, {3, 4, 5}, {6}};
+
+    auto f = flow::flatten(vecs);
+    std::vector<int> out;
+    (void) f.try_for_each([&out](auto m) {
+        out.push_back(*m);
+        return *m != 3;
+    });
+    REQUIRE(out == std::vector{1, 2, 3});
+
+    REQUIRE(f.next().value() == 4);
+    f.for_each([&out](int i) { out.push_back(i); });
+    REQUIRE(out == std::vector{1, 2, 3, 5, 6});
+}
+
+TEST_CASE("flatten to_vector() appends inner ranges", "[flow.flatten]")
+{
+    std::vector<std::vector<int>> vecs{{1, 2, 3}, {}, {4, 5}, {6}};
+
+    REQUIRE(flow::flatten(vecs).to_vector() == std::vector{1, 2, 3, 4, 5, 6});
+
+    // Partially-consumed first inner range
+    auto f = flow::flatten(vecs);
+    (void) f.next();
+    (void) f.next();
+    REQUIRE(std::move(f).to_vector() == std::vector{3, 4, 5, 6});
+
+    // flat_map() returning a container
+    auto g = flow::ints(0, 4).flat_map([](auto i) {
+        return std::vector<std::string>(static_cast<std::size_t>(i), std::to_string(i));
+    });
+    REQUIRE(std::move(g).to_vector() ==
+            std::vector<std::string>{"1", "2", "2", "3", "3", "3"});
+
+    // Explicit element type still goes item by item
+    REQUIRE(flow::flatten(vecs).to_vector<long>() == std::vector<long>{1, 2, 3, 4, 5, 6});
+}
+
 }
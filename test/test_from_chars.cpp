@@ -0,0 +1,82 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("from_chars() with a string", "[flow.from_chars]")
+{
+    SECTION("integers") {
+        auto vec = flow::from_chars<int>("  1 -2\t3\n\n 40  ").to_vector();
+        CHECK(vec == std::vector<int>{1, -2, 3, 40});
+    }
+
+    SECTION("floating point") {
+        auto vec = flow::from_chars<double>("0.5 -1e3 2").to_vector();
+        CHECK(vec == std::vector<double>{0.5, -1000.0, 2.0});
+    }
+
+    SECTION("custom delimiters") {
+        auto vec = flow::from_chars<unsigned>("1,2,,3;4", ",;").to_vector();
+        CHECK(vec == std::vector<unsigned>{1, 2, 3, 4});
+    }
+
+    SECTION("empty input") {
+        CHECK(flow::from_chars<int>("").count() == 0);
+        CHECK(flow::from_chars<int>("   ").count() == 0);
+    }
+
+    SECTION("stops at the first malformed value") {
+        auto vec = flow::from_chars<int>("1 2 3x 4").to_vector();
+        CHECK(vec == std::vector<int>{1, 2});
+
+        CHECK(flow::from_chars<signed char>("100 200 5").count() == 1);
+    }
+}
+
+TEST_CASE("from_chars() with a stream", "[flow.from_chars]")
+{
+    // Enough input to need several reads, so that values are split across
+    // the boundaries between blocks
+    std::string input;
+    for (int i = 0; i < 100'000; i++) {
+        input += std::to_string(i * 7 - 1000) + (i % 10 == 0 ? "\n" : " ");
+    }
+
+    std::istringstream iss(input);
+    auto expected = flow::from_istream<int>(iss).to_vector();
+    REQUIRE(expected.size() == 100'000);
+
+    SECTION("istream") {
+        std::istringstream is(input);
+        CHECK(flow::from_chars<int>(is).to_vector() == expected);
+    }
+
+    SECTION("FILE*") {
+        std::FILE* file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        std::fwrite(input.data(), 1, input.size(), file);
+        std::rewind(file);
+
+        CHECK(flow::from_chars<int>(file).to_vector() == expected);
+        std::fclose(file);
+    }
+}
+
+TEST_CASE("from_chars() with a value larger than a block", "[flow.from_chars]")
+{
+    // A single number with a very long fractional part
+    std::string input = "1 2." + std::string(200'000, '5') + " 3";
+    std::istringstream is(input);
+
+    auto vec = flow::from_chars<double>(is).to_vector();
+    CHECK(vec == std::vector<double>{1.0, 2.5555555555555554, 3.0});
+}
@@ -0,0 +1,148 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr bool test_from_columns_rows()
+{
+    std::array ids{1, 2, 3};
+    std::array prices{1.5, 2.5, 3.5};
+    std::array flags{true, false, true};
+
+    auto f = flow::from_columns(ids, prices, flags);
+
+    if (f.size() != 3) {
+        return false;
+    }
+
+    auto [id, price, flag] = f.next().value();
+    if (std::addressof(id) != ids.data() ||
+        std::addressof(price) != prices.data() || !flag) {
+        return false;
+    }
+
+    auto last = f.next_back().value();
+    if (std::get<0>(last) != 3 || std::get<1>(last) != 3.5) {
+        return false;
+    }
+
+    return f.size() == 1;
+}
+static_assert(test_from_columns_rows());
+
+constexpr bool test_from_columns_shortest()
+{
+    std::array a{1, 2, 3, 4};
+    std::array b{'a', 'b'};
+
+    auto f = flow::from_columns(a, b);
+
+    return f.size() == 2 && f.subflow().count() == 2 &&
+           std::move(f).values().equal(flow::of('a', 'b'));
+}
+static_assert(test_from_columns_shortest());
+
+constexpr bool test_from_columns_random_access()
+{
+    std::array a{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::array b{0, 10, 20, 30, 40, 50, 60, 70, 80, 90};
+
+    auto f = flow::from_columns(a, b);
+    static_assert(flow::is_random_access_flow<decltype(f)>);
+
+    if (f.advance(3)->second != 20) {
+        return false;
+    }
+
+    if (f.subflow().stride(3).keys().sum() != 3 + 6 + 9) {
+        return false;
+    }
+
+    return f.next()->first == 3;
+}
+static_assert(test_from_columns_random_access());
+
+constexpr bool test_from_columns_projection()
+{
+    std::array ids{1, 2, 3, 4};
+    std::array prices{1.0, 2.0, 3.0, 4.0};
+
+    auto f = flow::from_columns(ids, prices);
+    (void) f.next();
+    (void) f.next_back();
+
+    // Projection keeps the current position, and the column stays contiguous
+    auto col = std::move(f).values();
+    static_assert(flow::is_contiguous_flow<decltype(col)>);
+
+    return col.size() == 2 && col.data() == prices.data() + 1 &&
+           col.sum() == 5.0;
+}
+static_assert(test_from_columns_projection());
+
+}
+
+TEST_CASE("from_columns() with owned columns", "[flow.from_columns]")
+{
+    std::vector<std::string> names{"a", "b", "c"};
+    std::vector<int> scores{10, 20, 30};
+
+    auto f = flow::from_columns(std::move(names), std::move(scores));
+
+    // Rows refer to the columns stored in the flow, so can be modified
+    f.subflow().for_each([](auto row) { row.second *= 2; });
+
+    auto sub = f.subflow();
+    CHECK(sub.next()->first == "a");
+
+    auto vec = std::move(f).values().to_vector();
+    CHECK(vec == std::vector{20, 40, 60});
+}
+
+TEST_CASE("from_columns() elements projection", "[flow.from_columns]")
+{
+    std::vector<int> a{1, 2, 3};
+    std::vector<long> b{4, 5, 6};
+    std::vector<char> c{'x', 'y', 'z'};
+
+    auto f = flow::from_columns(a, b, c);
+    static_assert(flow::is_contiguous_flow<decltype(f.subflow().elements<2>())>);
+
+    CHECK(f.subflow().elements<1>().sum() == 15);
+    CHECK(flow::elements<2>(f.subflow()).to_string() == "xyz");
+
+    // Projections on other adaptors still go through the rows
+    CHECK(f.subflow().drop(1).elements<0>().to_vector() == std::vector{2, 3});
+}
+
+TEST_CASE("from_columns() projection with unequal columns", "[flow.from_columns]")
+{
+    auto make = [] {
+        return flow::from_columns(std::vector<int>{1, 2, 3}, std::vector<int>{4, 5});
+    };
+
+    CHECK(make().elements<0>().to_vector() == std::vector{1, 2});
+    CHECK(make().elements<0>().to<std::vector<int>>() == std::vector{1, 2});
+    CHECK(make().elements<1>().to_vector() == std::vector{4, 5});
+    CHECK(flow::equal(make().elements<0>().to_range(), std::vector{1, 2}));
+
+    // Rows which have already been consumed are not returned again
+    auto col = make().elements<0>();
+    (void) col.next();
+    CHECK(col.subflow().to_vector() == std::vector{2});
+    CHECK(std::move(col).to_vector() == std::vector{2});
+
+    auto col2 = make().elements<0>();
+    (void) col2.next();
+    CHECK(std::move(col2).to_range() == std::vector{2});
+}
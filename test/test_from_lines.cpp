@@ -0,0 +1,85 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using strings = std::vector<std::string>;
+
+auto to_strings = [](auto&& flow) {
+    return FLOW_FWD(flow).map([](std::string_view sv) { return std::string(sv); })
+                         .to_vector();
+};
+
+}
+
+TEST_CASE("from_lines() with a string", "[flow.from_lines]")
+{
+    SECTION("basic") {
+        CHECK(to_strings(flow::from_lines("one\ntwo\nthree\n")) ==
+              strings{"one", "two", "three"});
+    }
+
+    SECTION("without a final newline") {
+        CHECK(to_strings(flow::from_lines("one\ntwo")) == strings{"one", "two"});
+    }
+
+    SECTION("empty lines") {
+        CHECK(to_strings(flow::from_lines("\n\na\n\n")) == strings{"", "", "a", ""});
+        CHECK(flow::from_lines("").count() == 0);
+    }
+
+    SECTION("CRLF") {
+        CHECK(to_strings(flow::from_lines("a\r\nb\r\n")) == strings{"a\r", "b\r"});
+        CHECK(to_strings(flow::from_lines("a\r\nb\r\nc", true)) == strings{"a", "b", "c"});
+    }
+
+    SECTION("lines refer to the input") {
+        std::string_view input = "hello\nworld";
+        auto f = flow::from_lines(input);
+        CHECK(f.next()->data() == input.data());
+        CHECK(f.next()->data() == input.data() + 6);
+    }
+}
+
+TEST_CASE("from_lines() with a stream", "[flow.from_lines]")
+{
+    // Lines of varying lengths, so that some straddle the boundaries between
+    // blocks, including one much longer than a block
+    strings expected;
+    std::string input;
+    for (int i = 0; i < 20'000; i++) {
+        expected.push_back(std::string(static_cast<std::size_t>(i % 13), 'x') +
+                           std::to_string(i));
+    }
+    expected.push_back(std::string(200'000, 'y'));
+    expected.push_back("last");
+    for (auto const& line : expected) {
+        input += line + "\r\n";
+    }
+
+    SECTION("istream") {
+        std::istringstream is(input);
+        CHECK(to_strings(flow::from_lines(is, true)) == expected);
+    }
+
+    SECTION("FILE*") {
+        std::FILE* file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        std::fwrite(input.data(), 1, input.size() - 2, file); // no final CRLF
+        std::rewind(file);
+
+        CHECK(to_strings(flow::from_lines(file, true)) == expected);
+        std::fclose(file);
+    }
+}
@@ -0,0 +1,167 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct event {
+    int user_id;
+    std::string action;
+};
+
+struct user {
+    int id;
+    std::string name;
+};
+
+const std::vector<event> events = {
+    {1, "login"}, {3, "login"}, {2, "click"}, {1, "logout"}, {4, "login"}, {3, "click"}
+};
+
+const std::vector<user> users = {
+    {1, "alice"}, {2, "bob"}, {3, "carol"}, {3, "carol2"}
+};
+
+constexpr bool test_merge_join()
+{
+    // Basic merge join, with duplicate keys on both sides
+    {
+        std::array left{1, 2, 2, 3, 5, 6};
+        std::array right{2, 2, 3, 4, 6, 6};
+
+        auto f = flow::merge_join(left, right, flow::identity{}, flow::identity{});
+
+        static_assert(flow::is_flow<decltype(f)>);
+
+        auto expected = flow::of{2, 2, 2, 2, 3, 6, 6};
+        while (auto m = f.next()) {
+            auto e = expected.next();
+            if (!e || m->first != *e || m->second != *e) {
+                return false;
+            }
+        }
+        if (expected.next()) {
+            return false;
+        }
+    }
+
+    // Items yielded are references into the original flows
+    {
+        std::array left{1, 2};
+        std::array right{2, 3};
+
+        auto f = flow::merge_join(left, right, flow::identity{}, flow::identity{});
+        auto m = f.next();
+        if (!m || &m->first != &left[1] || &m->second != &right[0]) {
+            return false;
+        }
+        if (f.next()) {
+            return false;
+        }
+    }
+
+    // No matches
+    {
+        std::array left{1, 3, 5};
+        std::array right{2, 4, 6};
+
+        if (flow::merge_join(left, right, flow::identity{}, flow::identity{}).count() != 0) {
+            return false;
+        }
+    }
+
+    // Descending order, with a different key on each side
+    {
+        std::array left{6, 4, 2};
+        std::array right{30, 20, 10};
+
+        auto f = flow::from(left).merge_join(right, flow::identity{},
+                                             [](int i) { return i / 5; },
+                                             flow::greater{});
+        if (not std::move(f).map([](auto p) { return p.second; }).equal(flow::of{30, 20, 10})) {
+            return false;
+        }
+    }
+
+    return true;
+}
+static_assert(test_merge_join());
+
+}
+
+TEST_CASE("merge_join", "[flow.join]")
+{
+    REQUIRE(test_merge_join());
+}
+
+TEST_CASE("merge_join (single-pass left)", "[flow.join]")
+{
+    std::vector<std::string> left{"a", "b", "b", "c"};
+    std::vector<std::string> right{"b", "c", "c"};
+
+    auto out = flow::from(left)
+                   .map([](std::string const& s) { return s; }) // prvalues
+                   .merge_join(right, flow::identity{}, flow::identity{})
+                   .map([](auto const& p) { return p.first + p.second; })
+                   .to_vector();
+
+    REQUIRE((out == std::vector<std::string>{"bb", "bb", "cc", "cc"}));
+}
+
+TEST_CASE("hash_join", "[flow.join]")
+{
+    auto out = flow::from(events)
+                   .hash_join(users, &event::user_id, &user::id)
+                   .map([](auto const& p) { return p.second.name + ":" + p.first.action; })
+                   .to_vector();
+
+    REQUIRE((out == std::vector<std::string>{
+        "alice:login", "carol:login", "carol2:login", "bob:click",
+        "alice:logout", "carol:click", "carol2:click"}));
+}
+
+TEST_CASE("hash_join (empty build side)", "[flow.join]")
+{
+    REQUIRE(flow::hash_join(events, std::vector<user>{}, &event::user_id, &user::id).count() == 0);
+}
+
+TEST_CASE("hash_join (infinite probe side)", "[flow.join]")
+{
+    auto out = flow::iota(0)
+                   .hash_join(flow::of{10, 20, 30}, flow::identity{},
+                              [](int i) { return i / 10; })
+                   .map([](auto p) { return p.second; })
+                   .take(3)
+                   .to_vector();
+
+    REQUIRE((out == std::vector<int>{10, 20, 30}));
+}
+
+TEST_CASE("hash_join (large build side)", "[flow.join]")
+{
+    auto n = flow::ints(0, 10'000)
+                 .hash_join(flow::ints(0, 100'000, 2), flow::identity{}, flow::identity{})
+                 .count();
+
+    REQUIRE(n == 5000);
+}
+
+TEST_CASE("semi_join and anti_join", "[flow.join]")
+{
+    auto semi = flow::semi_join(events, users, &event::user_id, &user::id)
+                    .map(&event::user_id).to_vector();
+    REQUIRE((semi == std::vector<int>{1, 3, 2, 1, 3}));
+
+    auto anti = flow::anti_join(events, users, &event::user_id, &user::id)
+                    .map(&event::user_id).to_vector();
+    REQUIRE((anti == std::vector<int>{4}));
+}
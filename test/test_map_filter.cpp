@@ -0,0 +1,127 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr auto times2 = [](int i) { return i * 2; };
+constexpr auto plus1 = [](int i) { return i + 1; };
+constexpr auto div3 = [](int i) { return i % 3 == 0; };
+
+template <typename>
+constexpr bool is_fused = false;
+
+template <typename F, typename... S>
+constexpr bool is_fused<flow::detail::map_filter_adaptor<F, S...>> = true;
+
+constexpr bool test_map_filter_chain()
+{
+    auto f = flow::ints(0, 20)
+                .map(times2)
+                .filter(div3)
+                .map(plus1)
+                .filter(flow::pred::gt(10));
+
+    static_assert(is_fused<decltype(f)>);
+
+    // 0, 6, 12, ..., 36 -> 1, 7, 13, ..., 37 -> 13, 19, 25, 31, 37
+    return f.equal(flow::of(13, 19, 25, 31, 37));
+}
+static_assert(test_map_filter_chain());
+
+constexpr bool test_map_filter_only_maps()
+{
+    // A chain of maps keeps the properties of the underlying flow
+    std::array arr{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto f = flow::from(arr).map(times2).map(plus1);
+
+    static_assert(is_fused<decltype(f)>);
+    static_assert(flow::is_random_access_flow<decltype(f)>);
+    static_assert(flow::is_reversible_flow<decltype(f)>);
+
+    if (f.size() != 10 || *f.advance(3) != 5 || *f.next_back() != 19) {
+        return false;
+    }
+
+    auto inf = flow::ints().map(times2).map(plus1);
+    static_assert(flow::is_infinite_flow<decltype(inf)>);
+
+    return std::move(inf).take(3).equal(flow::of(1, 3, 5));
+}
+static_assert(test_map_filter_only_maps());
+
+constexpr bool test_map_filter_not_sized()
+{
+    auto f = flow::ints(0, 10).map(times2).filter(div3);
+
+    static_assert(!flow::is_sized_flow<decltype(f)>);
+    static_assert(!flow::is_infinite_flow<decltype(f)>);
+
+    auto inf = flow::ints().filter(div3).map(times2);
+    static_assert(!flow::is_infinite_flow<decltype(inf)>);
+
+    return std::move(inf).take(3).equal(flow::of(0, 6, 12));
+}
+static_assert(test_map_filter_not_sized());
+
+constexpr bool test_map_filter_subflow()
+{
+    auto f = flow::ints(0, 10).filter(flow::pred::odd).map(times2);
+
+    if (f.subflow().sum() != 2 + 6 + 10 + 14 + 18) {
+        return false;
+    }
+
+    (void) f.next();
+    return f.subflow().count() == 4 && f.count() == 4;
+}
+static_assert(test_map_filter_subflow());
+
+constexpr bool test_map_filter_try_fold()
+{
+    int calls = 0;
+    auto counted = [&calls](int i) { ++calls; return i; };
+
+    // Stops as soon as the callback returns false
+    auto f = flow::ints(0, 100).map(counted).filter(flow::pred::even);
+    bool found = f.any([](int i) { return i == 6; });
+
+    return found && calls == 7 && *f.next() == 8;
+}
+static_assert(test_map_filter_try_fold());
+
+constexpr bool test_map_filter_references()
+{
+    int arr[] = {1, 2, 3, 4};
+
+    // Filters after filters still yield references into the source
+    auto f = flow::from(arr).filter(flow::pred::even).filter(flow::pred::gt(2));
+    static_assert(std::is_same_v<flow::item_t<decltype(f)>, int&>);
+
+    return std::addressof(*f.next()) == arr + 3;
+}
+static_assert(test_map_filter_references());
+
+}
+
+TEST_CASE("map/filter fusion with move-only items", "[flow.map_filter]")
+{
+    std::vector<std::string> words{"apple", "kiwi", "banana", "fig"};
+
+    auto vec = flow::from(std::move(words))
+                   .filter([](std::string const& s) { return s.size() > 3; })
+                   .map([](std::string s) { return s + "!"; })
+                   .filter([](std::string const& s) { return s[0] != 'k'; })
+                   .to_vector();
+
+    CHECK(vec == std::vector<std::string>{"apple!", "banana!"});
+}
@@ -6,6 +6,7 @@
 #include <flow.hpp>
 
 #include <string>
+#include <string_view>
 
 #include "catch.hpp"
 
@@ -90,6 +91,19 @@ struct not_copy_assignable {
     not_copy_assignable& operator=(not_copy_assignable&&) = default;
 };
 
+// A user-defined type with a niche
+enum class color { red, green, blue, invalid_ };
+
+}
+
+template <>
+struct flow::maybe_traits<color> {
+    static constexpr color empty_value() noexcept { return color::invalid_; }
+    static constexpr bool is_empty(color c) noexcept { return c == color::invalid_; }
+};
+
+namespace {
+
 
 constexpr bool compile_tests()
 {
@@ -113,10 +127,66 @@ constexpr bool compile_tests()
     (void) test<not_copy_assignable&>{};
     (void) test<not_copy_assignable const&>{};
 
+    // Types with a niche
+    (void) test<std::string_view>{};
+    (void) test<color>{};
+
     return true;
 }
 static_assert(compile_tests());
 
+static_assert(sizeof(flow::maybe<std::string_view>) == sizeof(std::string_view));
+static_assert(sizeof(flow::maybe<color>) == sizeof(color));
+static_assert(sizeof(flow::maybe<int>) > sizeof(int));
+
+constexpr bool test_niche()
+{
+    using namespace std::string_view_literals;
+
+    // An empty string_view is not the same as an empty maybe
+    {
+        flow::maybe<std::string_view> m;
+        if (m.has_value()) {
+            return false;
+        }
+        m = flow::maybe<std::string_view>(""sv);
+        if (!m.has_value() || !m->empty()) {
+            return false;
+        }
+        m.reset();
+        if (m.has_value()) {
+            return false;
+        }
+    }
+
+    {
+        flow::maybe<color> m = color::red;
+        if (!m || *m != color::red) {
+            return false;
+        }
+        auto m2 = m.map([](color c) { return c == color::red ? color::blue : c; });
+        static_assert(std::is_same_v<decltype(m2), flow::maybe<color>>);
+        if (m2.value_or(color::green) != color::blue) {
+            return false;
+        }
+        if (flow::maybe<color>{}.value_or(color::green) != color::green) {
+            return false;
+        }
+    }
+
+    // Flows of niche types work as normal
+    {
+        std::array<std::string_view, 3> arr{"a"sv, ""sv, "c"sv};
+        auto f = flow::from(arr).map([](std::string_view sv) { return sv; });
+        if (f.count() != 3) {
+            return false;
+        }
+    }
+
+    return true;
+}
+static_assert(test_niche());
+
 TEST_CASE("maybe")
 {
     auto m = flow::maybe<std::unique_ptr<int>>{};
@@ -129,6 +199,11 @@ TEST_CASE("maybe")
     REQUIRE(**m == 3);
 }
 
+TEST_CASE("maybe (niche)")
+{
+    REQUIRE(test_niche());
+}
+
 
 }
 
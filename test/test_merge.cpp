@@ -0,0 +1,170 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+constexpr bool test_merge()
+{
+    std::array arr1{1, 4, 7};
+    std::array arr2{2, 5, 8};
+    std::array arr3{3, 6, 9};
+
+    auto m = flow::merge(flow::less{}, arr1, arr2, arr3);
+
+    if (m.size() != 9) {
+        return false;
+    }
+
+    if (!m.equal(flow::ints(1, 10))) {
+        return false;
+    }
+
+    return true;
+}
+static_assert(test_merge());
+
+TEST_CASE("merge", "[flow.merge]")
+{
+    SECTION("basic merge")
+    {
+        std::vector vec1{1, 3, 5, 7};
+        std::vector vec2{2, 4, 6};
+
+        auto m = flow::merge(flow::less{}, vec1, vec2);
+        static_assert(std::is_same_v<flow::item_t<decltype(m)>, int&>);
+        static_assert(flow::is_multipass_flow<decltype(m)>);
+        REQUIRE(m.size() == 7);
+
+        REQUIRE(std::move(m).to_vector() == std::vector{1, 2, 3, 4, 5, 6, 7});
+    }
+
+    SECTION("empty flows")
+    {
+        auto m = flow::merge(flow::less{}, flow::empty<int>(), flow::empty<int>());
+        REQUIRE_FALSE(m.next().has_value());
+    }
+
+    SECTION("merge is stable")
+    {
+        using P = std::pair<int, char>;
+        std::vector<P> vec1{{1, 'a'}, {2, 'a'}};
+        std::vector<P> vec2{{1, 'b'}, {2, 'b'}};
+
+        auto cmp = [](P const& lhs, P const& rhs) { return lhs.first < rhs.first; };
+
+        auto out = flow::from(vec1).merge(cmp, vec2).to_vector();
+        REQUIRE(out == std::vector<P>{{1, 'a'}, {1, 'b'}, {2, 'a'}, {2, 'b'}});
+    }
+
+    SECTION("descending merge")
+    {
+        auto out = flow::of(9, 5, 1).merge(std::greater<>{}, flow::of(8, 6), flow::of(7, 0)).copy().to_vector();
+        REQUIRE(out == std::vector{9, 8, 7, 6, 5, 1, 0});
+    }
+
+    SECTION("subflows")
+    {
+        std::vector vec1{1, 3, 5};
+        std::vector vec2{2, 4, 6};
+
+        auto m = flow::merge(flow::less{}, vec1, vec2);
+        (void) m.next();
+
+        auto s = m.subflow();
+        REQUIRE(s.size() == 5);
+        REQUIRE(s.equal(flow::ints(2, 7)));
+        REQUIRE(m.equal(flow::ints(2, 7)));
+    }
+}
+
+TEST_CASE("merge_all", "[flow.merge_all]")
+{
+    SECTION("no flows")
+    {
+        auto m = flow::merge_all(std::vector<flow::empty<int>>{});
+        REQUIRE_FALSE(m.next().has_value());
+    }
+
+    SECTION("single flow")
+    {
+        std::vector<std::vector<int>> shards{{1, 2, 3}};
+
+        std::vector<decltype(flow::from(shards[0]))> flows;
+        flows.push_back(flow::from(shards[0]));
+
+        auto m = flow::merge_all(std::move(flows));
+        REQUIRE(m.size() == 3);
+        REQUIRE(std::move(m).copy().to_vector() == std::vector{1, 2, 3});
+    }
+
+    SECTION("many flows")
+    {
+        std::vector<std::vector<int>> shards;
+        std::vector<int> expected;
+        for (int i = 0; i < 13; i++) {
+            auto& shard = shards.emplace_back();
+            for (int j = 0; j < 50 + i; j++) {
+                shard.push_back((j * 7 + i * 3) % 101);
+            }
+            std::sort(shard.begin(), shard.end());
+            expected.insert(expected.end(), shard.begin(), shard.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        using flow_type = decltype(flow::from(shards[0]));
+        std::vector<flow_type> flows;
+        for (auto& shard : shards) {
+            flows.push_back(flow::from(shard));
+        }
+
+        auto m = flow::merge_all(std::move(flows));
+        REQUIRE(m.size() == static_cast<flow::dist_t>(expected.size()));
+        REQUIRE(std::move(m).copy().to_vector() == expected);
+    }
+
+    SECTION("stability and custom comparator")
+    {
+        using P = std::pair<int, int>;
+        std::vector<std::vector<P>> shards{
+            {{3, 0}, {1, 0}},
+            {{3, 1}, {2, 1}, {1, 1}},
+            {{2, 2}}
+        };
+
+        std::vector<decltype(flow::from(shards[0]))> flows;
+        for (auto& shard : shards) {
+            flows.push_back(flow::from(shard));
+        }
+
+        auto out = flow::merge_all(std::move(flows), [](P const& lhs, P const& rhs) {
+            return lhs.first > rhs.first;
+        }).copy().to_vector();
+
+        REQUIRE(out == std::vector<P>{{3, 0}, {3, 1}, {2, 1}, {2, 2}, {1, 0}, {1, 1}});
+    }
+
+    SECTION("single-pass flows")
+    {
+        std::istringstream iss1("1 4 7");
+        std::istringstream iss2("2 5 8");
+        std::istringstream iss3("3 6 9");
+
+        std::vector<decltype(flow::from_istream<int>(iss1))> flows;
+        flows.push_back(flow::from_istream<int>(iss1));
+        flows.push_back(flow::from_istream<int>(iss2));
+        flows.push_back(flow::from_istream<int>(iss3));
+
+        REQUIRE(flow::merge_all(std::move(flows)).equal(flow::ints(1, 10)));
+    }
+}
+
+}
@@ -117,5 +117,40 @@ constexpr bool test_combiners()
 }
 static_assert(test_combiners());
 
+// Built-in predicates and their combinations are "pure"
+constexpr auto user_pred = [](int i) { return i > 3; };
+
+static_assert(pred::is_pure_predicate<decltype(pred::even)>);
+static_assert(pred::is_pure_predicate<decltype(pred::eq(3))>);
+static_assert(pred::is_pure_predicate<decltype(pred::in(1, 2, 3))>);
+static_assert(pred::is_pure_predicate<decltype(pred::both(pred::even, pred::lt(10)))>);
+static_assert(pred::is_pure_predicate<decltype(pred::even || pred::gt(10))>);
+static_assert(pred::is_pure_predicate<decltype(!pred::positive)>);
+static_assert(pred::is_pure_predicate<decltype(pred::neither(pred::odd, pred::negative))>);
+
+static_assert(not pred::is_pure_predicate<decltype(user_pred)>);
+static_assert(not pred::is_pure_predicate<decltype(pred::not_(user_pred))>);
+static_assert(not pred::is_pure_predicate<decltype(pred::both(pred::even, user_pred))>);
+
+constexpr bool test_pure_combiners()
+{
+    constexpr auto p = pred::in('(', ')') || pred::eq('x');
+
+    static_assert(p('('));
+    static_assert(p(')'));
+    static_assert(p('x'));
+    static_assert(!p('y'));
+
+    constexpr auto q = pred::geq(2) && pred::lt(5) && !pred::eq(3);
+
+    static_assert(!q(1));
+    static_assert(q(2));
+    static_assert(!q(3));
+    static_assert(q(4));
+    static_assert(!q(5));
+
+    return true;
 }
+static_assert(test_pure_combiners());
 
+}
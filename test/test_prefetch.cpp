@@ -0,0 +1,108 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#ifdef FLOW_HAVE_POSIX_IO
+
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A temporary file holding the given contents, which is removed on
+// destruction
+struct temp_file {
+    explicit temp_file(std::string const& contents)
+        : file_(std::tmpfile())
+    {
+        REQUIRE(file_ != nullptr);
+        std::fwrite(contents.data(), 1, contents.size(), file_);
+        std::fflush(file_);
+    }
+
+    ~temp_file() { std::fclose(file_); }
+
+    auto fd() const -> int { return fileno(file_); }
+
+private:
+    std::FILE* file_;
+};
+
+}
+
+TEST_CASE("from_file_prefetched() yields the file in blocks", "[flow.prefetch]")
+{
+    std::string contents;
+    for (int i = 0; i < 10'000; i++) {
+        contents += std::to_string(i) + ' ';
+    }
+    temp_file file(contents);
+
+    SECTION("as chunks") {
+        auto f = flow::from_file_prefetched(file.fd(), 4096, 3);
+
+        std::string out;
+        std::size_t num_chunks = 0;
+        while (auto chunk = f.next()) {
+            CHECK(chunk->size() <= 4096);
+            out += *chunk;
+            ++num_chunks;
+        }
+
+        CHECK(out == contents);
+        CHECK(num_chunks == (contents.size() + 4095) / 4096);
+        CHECK(f.error() == 0);
+    }
+
+    SECTION("as characters") {
+        auto n = flow::from_file_prefetched(file.fd(), 1000).flatten().count(' ');
+        CHECK(n == 10'000);
+    }
+
+    SECTION("parsed with from_chars()") {
+        auto f = flow::from_chars<int>(flow::from_file_prefetched(file.fd(), 512));
+        CHECK(std::move(f).sum() == 9999 * 10'000 / 2);
+    }
+
+    SECTION("split with from_lines()") {
+        temp_file lines("one\ntwo\nthree");
+        auto vec = flow::from_lines(flow::from_file_prefetched(lines.fd(), 2))
+                       .map([](std::string_view sv) { return std::string(sv); })
+                       .to_vector();
+        CHECK(vec == std::vector<std::string>{"one", "two", "three"});
+    }
+
+    SECTION("abandoned before the end") {
+        auto f = flow::from_file_prefetched(file.fd(), 16, 2);
+        CHECK(f.next().has_value());
+        // Destroying the flow must stop the reader thread
+    }
+}
+
+TEST_CASE("from_file_prefetched() with an empty file", "[flow.prefetch]")
+{
+    temp_file file("");
+    auto f = flow::from_file_prefetched(file.fd());
+    CHECK(!f.next().has_value());
+    CHECK(f.error() == 0);
+}
+
+TEST_CASE("from_file_prefetched() errors", "[flow.prefetch]")
+{
+    auto f = flow::from_file_prefetched("/this/path/does/not/exist");
+    CHECK(!f.next().has_value());
+    CHECK(f.error() == ENOENT);
+
+    auto g = flow::from_file_prefetched(-1);
+    CHECK(!g.next().has_value());
+    CHECK(g.error() == EBADF);
+}
+
+#endif
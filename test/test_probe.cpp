@@ -0,0 +1,122 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <sstream>
+#include <vector>
+
+#ifndef FLOW_INSTRUMENTED
+
+namespace {
+
+constexpr bool test_probe_disabled()
+{
+    // With instrumentation disabled, probe() returns the flow by value
+    auto f = flow::ints(0, 10).probe("source").filter(flow::pred::even);
+    static_assert(std::is_same_v<decltype(flow::ints(0, 10).probe("x")),
+                                 decltype(flow::ints(0, 10))>);
+    static_assert(!flow::instrumented);
+
+    return std::move(f).probe("even").sum() == 0 + 2 + 4 + 6 + 8;
+}
+static_assert(test_probe_disabled());
+
+}
+
+TEST_CASE("probe() with instrumentation disabled", "[flow.probe]")
+{
+    std::vector<int> vec{1, 2, 3};
+    CHECK(flow::probe(vec, "vec").sum() == 6);
+}
+
+TEST_CASE("probe() result can be bound to a reference", "[flow.probe]")
+{
+    int sum = 0;
+    FLOW_FOR(int i, flow::of(1, 2, 3).probe("x")) {
+        sum += i;
+    }
+    CHECK(sum == 6);
+
+    auto&& f = flow::ints(0, 4).probe("y");
+    CHECK(f.sum() == 0 + 1 + 2 + 3);
+}
+
+#else
+
+namespace {
+
+auto& find_stats(std::string_view name)
+{
+    return flow::probe_registry::instance().get(name);
+}
+
+}
+
+TEST_CASE("probe() counts calls and items", "[flow.probe]")
+{
+    static_assert(flow::instrumented);
+    flow::probe_registry::instance().reset();
+
+    auto f = flow::ints(0, 100).probe("counts.source");
+    static_assert(flow::is_sized_flow<decltype(f)>);
+    CHECK(f.size() == 100);
+
+    CHECK(std::move(f).take(10).count() == 10);
+
+    auto& stats = find_stats("counts.source");
+    CHECK(stats.calls == 10);
+    CHECK(stats.items == 10);
+    CHECK(stats.sampled_calls == 1);
+    CHECK(stats.first_ns >= 0);
+    CHECK(!stats.upstream.load());
+
+    // Running it again accumulates, including the final empty call
+    CHECK(flow::probe(flow::ints(0, 5), "counts.source").count() == 5);
+    CHECK(stats.calls == 16);
+    CHECK(stats.items == 15);
+}
+
+TEST_CASE("probe() reports filter selectivity", "[flow.probe]")
+{
+    flow::probe_registry::instance().reset();
+
+    auto total = flow::ints(0, 1000)
+                     .probe("sel.input")
+                     .filter([](auto i) { return i % 4 == 0; })
+                     .probe("sel.output")
+                     .count();
+    CHECK(total == 250);
+
+    auto& in = find_stats("sel.input");
+    auto& out = find_stats("sel.output");
+
+    CHECK(in.items == 1000);
+    CHECK(out.items == 250);
+    CHECK(out.upstream.load() == &in);
+    CHECK(out.selectivity().value() == 0.25);
+    CHECK(!in.selectivity().has_value());
+}
+
+TEST_CASE("probe registry output", "[flow.probe]")
+{
+    flow::probe_registry::instance().reset();
+
+    (void) flow::of(1, 2, 3).probe("out.\"quoted\"").sum();
+
+    std::ostringstream json;
+    flow::probe_registry::instance().write_json(json);
+    CHECK(json.str().find("\"name\":\"out.\\\"quoted\\\"\",\"calls\":4,\"items\":3") !=
+          std::string::npos);
+
+    std::ostringstream trace;
+    flow::probe_registry::instance().write_chrome_trace(trace);
+    CHECK(trace.str().rfind("{\"traceEvents\":[", 0) == 0);
+    CHECK(trace.str().find("\"ph\":\"X\"") != std::string::npos);
+}
+
+#endif
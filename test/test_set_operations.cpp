@@ -0,0 +1,146 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+namespace {
+
+constexpr bool test_set_union()
+{
+    auto u = flow::set_union(std::array{1, 3, 5, 5}, std::array{2, 3, 5, 6});
+    return u.equal(flow::of(1, 2, 3, 5, 5, 6));
+}
+static_assert(test_set_union());
+
+constexpr bool test_set_intersection()
+{
+    auto i = flow::set_intersection(std::array{1, 3, 5, 5, 7}, std::array{2, 3, 5, 6});
+    return i.equal(flow::of(3, 5));
+}
+static_assert(test_set_intersection());
+
+constexpr bool test_set_difference()
+{
+    auto d = flow::set_difference(std::array{1, 3, 5, 5, 7}, std::array{2, 3, 5, 6});
+    return d.equal(flow::of(1, 5, 7));
+}
+static_assert(test_set_difference());
+
+// Compare against the standard library for a selection of inputs
+template <typename Op, typename StdOp>
+void check_against_std(Op op, StdOp std_op)
+{
+    const std::vector<std::vector<int>> inputs{
+        {},
+        {1},
+        {1, 1, 1},
+        {1, 2, 3, 4, 5},
+        {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20},
+        {5, 5, 6, 6, 7, 100},
+        {-10, -5, 0, 3, 3, 3, 50, 60, 70, 80, 90, 100, 110}
+    };
+
+    for (auto const& a : inputs) {
+        for (auto const& b : inputs) {
+            std::vector<int> expected;
+            std_op(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+            // Random-access (galloping) path
+            REQUIRE(op(flow::from(a), flow::from(b)).copy().to_vector() == expected);
+
+            // Non-random-access path
+            auto not_ra = [](auto const& v) {
+                return flow::from(v).filter([](int) { return true; });
+            };
+            REQUIRE(op(not_ra(a), not_ra(b)).copy().to_vector() == expected);
+        }
+    }
+}
+
+TEST_CASE("set_union", "[flow.set_union]")
+{
+    check_against_std(flow::set_union, [](auto... args) { return std::set_union(args...); });
+
+    SECTION("descending")
+    {
+        auto vec = flow::of(5, 3, 1).set_union(flow::of(4, 3, 2), std::greater<>{}).copy().to_vector();
+        REQUIRE(vec == std::vector{5, 4, 3, 2, 1});
+    }
+
+    SECTION("subflows")
+    {
+        std::vector a{1, 3, 5};
+        std::vector b{2, 4};
+
+        auto u = flow::set_union(a, b);
+        (void) u.next();
+        REQUIRE(u.subflow().equal(flow::of(2, 3, 4, 5)));
+        REQUIRE(u.equal(flow::of(2, 3, 4, 5)));
+    }
+}
+
+TEST_CASE("set_intersection", "[flow.set_intersection]")
+{
+    check_against_std(flow::set_intersection,
+                      [](auto... args) { return std::set_intersection(args...); });
+
+    SECTION("large skips")
+    {
+        std::vector<int> big(100'000);
+        std::iota(big.begin(), big.end(), 0);
+        std::vector small{5, 50'000, 99'999, 200'000};
+
+        int comparisons = 0;
+        auto counting_less = [&comparisons](int a, int b) {
+            ++comparisons;
+            return a < b;
+        };
+
+        auto out = flow::set_intersection(big, small, counting_less).copy().to_vector();
+        REQUIRE(out == std::vector{5, 50'000, 99'999});
+        // Without galloping, we'd need at least 100'000 comparisons
+        REQUIRE(comparisons < 1'000);
+    }
+
+    SECTION("single-pass flows")
+    {
+        std::istringstream iss1("1 2 3 4 5 6");
+        std::istringstream iss2("2 4 6 8");
+        auto out = flow::from_istream<int>(iss1)
+                       .set_intersection(flow::from_istream<int>(iss2))
+                       .to_vector();
+        REQUIRE(out == std::vector{2, 4, 6});
+    }
+}
+
+TEST_CASE("set_difference", "[flow.set_difference]")
+{
+    check_against_std(flow::set_difference,
+                      [](auto... args) { return std::set_difference(args...); });
+
+    SECTION("heterogeneous comparison")
+    {
+        struct S {
+            int key;
+        };
+
+        struct cmp {
+            bool operator()(S const& s, int i) const { return s.key < i; }
+            bool operator()(int i, S const& s) const { return i < s.key; }
+        };
+
+        std::vector<S> vec{{1}, {2}, {3}, {4}};
+        auto out = flow::from(vec).set_difference(flow::of(2, 4), cmp{}).map(&S::key).to_vector();
+        REQUIRE(out == std::vector{1, 3});
+    }
+}
+
+}
@@ -0,0 +1,171 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+TEST_CASE("approx_count_distinct", "[flow.sketches]")
+{
+    SECTION("empty flow") {
+        REQUIRE(flow::empty<int>().approx_count_distinct() == 0);
+    }
+
+    SECTION("small cardinality is (nearly) exact") {
+        auto n = flow::ints(0, 10'000).map([](auto i) { return i % 100; })
+                     .approx_count_distinct();
+        REQUIRE(std::abs(n - 100) <= 2);
+    }
+
+    SECTION("large cardinality within a few percent") {
+        auto n = flow::ints(0, 1'000'000).approx_count_distinct();
+        REQUIRE(std::abs(n - 1'000'000) < 50'000);
+    }
+
+    SECTION("strings") {
+        std::vector<std::string> words{"a", "b", "a", "c", "b", "a"};
+        REQUIRE(flow::approx_count_distinct(words) == 3);
+    }
+}
+
+TEST_CASE("hyperloglog merge and fold", "[flow.sketches]")
+{
+    auto first = flow::ints(0, 60'000).fold(flow::sketch_insert, flow::hyperloglog<flow::dist_t>{});
+    auto second = flow::ints(40'000, 100'000).fold(flow::sketch_insert, flow::hyperloglog<flow::dist_t>{});
+
+    first.merge(second);
+    REQUIRE(std::abs(first.estimate() - 100'000) < 5'000);
+}
+
+TEST_CASE("approx_quantiles", "[flow.sketches]")
+{
+    SECTION("empty flow") {
+        auto sketch = flow::empty<int>().approx_quantiles();
+        REQUIRE(sketch.count() == 0);
+        REQUIRE_FALSE(sketch.quantile(0.5).has_value());
+    }
+
+    SECTION("small flows are exact") {
+        auto sketch = flow::of{5, 1, 4, 2, 3}.approx_quantiles();
+        REQUIRE(*sketch.quantile(0.0) == 1);
+        REQUIRE(*sketch.quantile(0.5) == 3);
+        REQUIRE(*sketch.quantile(1.0) == 5);
+    }
+
+    SECTION("large flows") {
+        // A permutation of 0..99999
+        auto sketch = flow::ints(0, 100'000)
+                          .map([](auto i) { return (i * 7919) % 100'000; })
+                          .approx_quantiles();
+
+        REQUIRE(sketch.count() == 100'000);
+        REQUIRE(std::abs(*sketch.quantile(0.5) - 50'000) < 2'000);
+        REQUIRE(std::abs(*sketch.quantile(0.99) - 99'000) < 2'000);
+        REQUIRE(std::abs(sketch.rank(25'000) - 0.25) < 0.02);
+    }
+
+    SECTION("merging") {
+        auto a = flow::ints(0, 50'000).approx_quantiles();
+        auto b = flow::ints(50'000, 100'000).approx_quantiles();
+        a.merge(b);
+
+        REQUIRE(a.count() == 100'000);
+        REQUIRE(std::abs(*a.quantile(0.5) - 50'000) < 2'000);
+    }
+}
+
+TEST_CASE("heavy_hitters", "[flow.sketches]")
+{
+    SECTION("exact when there are fewer items than counters") {
+        auto top = flow::of{1, 2, 2, 3, 3, 3}.heavy_hitters(10);
+
+        REQUIRE(top.size() == 3);
+        REQUIRE(top[0].item == 3);
+        REQUIRE(top[0].count == 3);
+        REQUIRE(top[0].error == 0);
+        REQUIRE(top[1].item == 2);
+        REQUIRE(top[2].item == 1);
+    }
+
+    SECTION("frequent items survive a long tail") {
+        // Item 0 makes up a third of the flow; everything else is unique
+        auto f = flow::ints(0, 30'000).map([](auto i) { return i % 3 == 0 ? 0 : i; });
+        auto top = flow::heavy_hitters(f, 10);
+
+        REQUIRE(top.size() == 10);
+        REQUIRE(top[0].item == 0);
+        REQUIRE(top[0].count - top[0].error <= 10'000);
+        REQUIRE(top[0].count >= 10'000);
+    }
+
+    SECTION("merging") {
+        flow::space_saving<int> a(4), b(4);
+        for (int i : {1, 1, 1, 2, 3}) { a.insert(i); }
+        for (int i : {1, 4, 4, 4, 4}) { b.insert(i); }
+        a.merge(b);
+
+        auto top = a.top();
+        REQUIRE(top.size() == 4);
+        REQUIRE(top[0].item == 1);
+        REQUIRE(top[0].count == 4);
+        REQUIRE(top[1].item == 4);
+        REQUIRE(top[1].count == 4);
+    }
+
+    SECTION("merging full sketches") {
+        std::map<int, flow::dist_t> truth;
+        flow::space_saving<int> a(5), b(5);
+        auto feed = [&](auto& sk, int item, int times) {
+            for (int i = 0; i < times; i++) {
+                sk.insert(item);
+                ++truth[item];
+            }
+        };
+
+        feed(a, 0, 100);
+        feed(a, 1, 50);
+        for (int i = 100; i < 200; i++) { feed(a, i, 1); }
+        feed(b, 0, 30);
+        feed(b, 2, 80);
+        for (int i = 200; i < 300; i++) { feed(b, i, 1); }
+
+        a.merge(b);
+        auto top = a.top();
+        REQUIRE(top.size() == 5);
+
+        // The true count of every tracked item is within the reported bounds
+        for (auto const& h : top) {
+            REQUIRE(h.count - h.error <= truth[h.item]);
+            REQUIRE(truth[h.item] <= h.count);
+        }
+
+        // Item 0 occurs more than n/k = 460/5 times, so must be tracked
+        REQUIRE(top[0].item == 0);
+        REQUIRE(top[0].count >= 130);
+    }
+
+    SECTION("merging with itself") {
+        flow::space_saving<int> sk(3);
+        for (int i : {1, 1, 1, 2, 2, 3, 4, 5}) { sk.insert(i); }
+        std::map<int, std::pair<flow::dist_t, flow::dist_t>> before;
+        for (auto const& h : sk.top()) {
+            before[h.item] = {h.count, h.error};
+        }
+
+        sk.merge(sk);
+        auto after = sk.top();
+        REQUIRE(after.size() == before.size());
+        for (auto const& h : after) {
+            REQUIRE(before.count(h.item) == 1);
+            REQUIRE(h.count == 2 * before[h.item].first);
+            REQUIRE(h.error == 2 * before[h.item].second);
+        }
+    }
+}
@@ -0,0 +1,205 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using namespace std::literals;
+
+template <typename T>
+auto random_vector(std::size_t n, T lo, T hi)
+{
+    std::mt19937 gen{12345};
+    std::uniform_int_distribution<T> dist(lo, hi);
+    std::vector<T> vec(n);
+    std::generate(vec.begin(), vec.end(), [&] { return dist(gen); });
+    return vec;
+}
+
+TEST_CASE("sorted", "[flow.sorted]")
+{
+    SECTION("empty flow")
+    {
+        REQUIRE(flow::empty<int>().sorted().empty());
+    }
+
+    SECTION("small flow")
+    {
+        REQUIRE(flow::of(3, 1, 2).sorted() == std::vector{1, 2, 3});
+        REQUIRE(flow::sorted(std::vector{3, 1, 2}, std::greater<>{}) == std::vector{3, 2, 1});
+    }
+
+    SECTION("strings")
+    {
+        std::vector strs{"b"s, "c"s, "a"s};
+        REQUIRE(flow::sorted(strs) == std::vector{"a"s, "b"s, "c"s});
+        // Make sure we didn't modify the original
+        REQUIRE(strs == std::vector{"b"s, "c"s, "a"s});
+    }
+
+    SECTION("with pointer to member")
+    {
+        struct S {
+            int i;
+            bool is_less(const S& other) const { return i < other.i; }
+        };
+
+        auto vec = flow::of(S{2}, S{3}, S{1}).sorted(&S::is_less);
+        REQUIRE(flow::from(vec).map(&S::i).equal(flow::of(1, 2, 3)));
+    }
+
+    SECTION("radix sort, signed")
+    {
+        auto vec = random_vector<long long>(10'000, -1'000'000'000'000, 1'000'000'000'000);
+        auto sorted = flow::sorted(vec);
+
+        std::sort(vec.begin(), vec.end());
+        REQUIRE(sorted == vec);
+    }
+
+    SECTION("radix sort, unsigned descending")
+    {
+        auto vec = random_vector<unsigned>(10'000, 0, 100);
+        auto sorted = flow::sorted(vec, std::greater<unsigned>{});
+
+        std::sort(vec.begin(), vec.end(), std::greater<>{});
+        REQUIRE(sorted == vec);
+    }
+
+    SECTION("single-pass flow")
+    {
+        std::istringstream iss("3 5 1 4 2");
+        auto vec = flow::from_istream<int>(iss).sorted();
+        REQUIRE(vec == std::vector{1, 2, 3, 4, 5});
+    }
+}
+
+TEST_CASE("par_sorted", "[flow.sorted]")
+{
+    SECTION("small flow")
+    {
+        REQUIRE(flow::of(3, 1, 2).par_sorted() == std::vector{1, 2, 3});
+        REQUIRE(flow::empty<std::string>().par_sorted().empty());
+    }
+
+    SECTION("large flow, comparison sort")
+    {
+        // More chunks than threads are likely, and the size is not a
+        // multiple of the number of chunks
+        auto ints = random_vector<long long>(300'001, -1'000'000, 1'000'000);
+        auto vec = flow::from(ints).map([](long long i) { return std::to_string(i); }).to_vector();
+
+        auto sorted = flow::par_sorted(vec);
+        std::sort(vec.begin(), vec.end());
+        REQUIRE(sorted == vec);
+
+        auto desc = flow::from(ints).par_sorted([](long long a, long long b) { return a > b; });
+        std::sort(ints.begin(), ints.end(), std::greater<>{});
+        REQUIRE(desc == ints);
+    }
+
+    SECTION("chunks are merged correctly")
+    {
+        // The machine running the tests may have only one core, so use the
+        // underlying sort directly with an awkward number of threads
+        for (std::size_t threads : {2, 3, 7, 8}) {
+            auto vec = random_vector<long long>(300'001, -1'000'000, 1'000'000);
+            auto expected = vec;
+            std::sort(expected.begin(), expected.end());
+
+            auto cmp = flow::less{};
+            flow::detail::parallel_sort(vec, cmp, threads);
+            REQUIRE(vec == expected);
+        }
+    }
+
+    SECTION("integers use the radix sort")
+    {
+        auto vec = random_vector<int>(100'000, -1000, 1000);
+        auto sorted = flow::par_sorted(vec, std::greater<>{});
+
+        std::sort(vec.begin(), vec.end(), std::greater<>{});
+        REQUIRE(sorted == vec);
+    }
+
+    SECTION("exceptions from the comparator are rethrown")
+    {
+        auto vec = random_vector<long long>(100'000, 0, 1'000'000);
+        auto throwing = [](long long a, long long b) {
+            if (a == 500'000 || b == 500'000) {
+                throw std::runtime_error("bad item");
+            }
+            return a < b;
+        };
+        vec.push_back(500'000);
+        REQUIRE_THROWS_AS(flow::par_sorted(vec, throwing), std::runtime_error);
+        REQUIRE_THROWS_AS(flow::detail::parallel_sort(vec, throwing, 4), std::runtime_error);
+    }
+}
+
+TEST_CASE("top_k", "[flow.top_k]")
+{
+    SECTION("empty flow")
+    {
+        REQUIRE(flow::empty<int>().top_k(3).empty());
+    }
+
+    SECTION("k == 0")
+    {
+        REQUIRE(flow::of(1, 2, 3).top_k(0).empty());
+    }
+
+    SECTION("fewer items than k")
+    {
+        REQUIRE(flow::of(3, 1, 2).top_k(10) == std::vector{1, 2, 3});
+    }
+
+    SECTION("smallest items")
+    {
+        REQUIRE(flow::ints(0, 100).map([](auto i) { return (i * 37) % 100; }).top_k(3)
+                == std::vector<flow::dist_t>{0, 1, 2});
+    }
+
+    SECTION("largest items")
+    {
+        auto vec = random_vector<int>(10'000, -100'000, 100'000);
+        auto top = flow::top_k(vec, 100, std::greater<>{});
+
+        std::sort(vec.begin(), vec.end(), std::greater<>{});
+        vec.resize(100);
+        REQUIRE(top == vec);
+    }
+
+    SECTION("single-pass flow")
+    {
+        std::istringstream iss("3 5 1 4 2");
+        auto vec = flow::from_istream<int>(iss).top_k(2, std::greater<>{});
+        REQUIRE(vec == std::vector{5, 4});
+    }
+}
+
+TEST_CASE("nth_element", "[flow.nth_element]")
+{
+    REQUIRE_FALSE(flow::empty<int>().nth_element(0).has_value());
+
+    REQUIRE(flow::of(5, 3, 4, 1, 2).nth_element(0).value() == 1);
+
+    REQUIRE(flow::of(5, 3, 4, 1, 2).nth_element(2).value() == 3);
+
+    REQUIRE(flow::nth_element(std::vector{5, 3, 4, 1, 2}, 1, std::greater<>{}).value() == 4);
+
+    REQUIRE_FALSE(flow::of(5, 3, 4, 1, 2).nth_element(5).has_value());
+}
+
+}
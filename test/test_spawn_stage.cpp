@@ -0,0 +1,111 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST_CASE("spawn_stage() yields the upstream items in order", "[flow.spawn_stage]")
+{
+    auto vec = flow::ints(0, 10'000)
+                   .map([](int i) { return i * 3; })
+                   .spawn_stage(64)
+                   .filter(flow::pred::even)
+                   .to_vector();
+
+    REQUIRE(vec.size() == 5'000);
+    REQUIRE(flow::equal(vec, flow::ints(0, 10'000).map([](int i) { return i * 3; })
+                                 .filter(flow::pred::even)));
+}
+
+TEST_CASE("spawn_stage() runs upstream on another thread", "[flow.spawn_stage]")
+{
+    const auto this_id = std::this_thread::get_id();
+
+    auto ids = flow::ints(0, 10)
+                   .map([](int) { return std::this_thread::get_id(); })
+                   .spawn_stage(4)
+                   .to_vector();
+
+    REQUIRE(ids.size() == 10);
+    REQUIRE(flow::all(ids, [&](auto id) { return id != this_id; }));
+}
+
+TEST_CASE("spawn_stage() stages may be chained", "[flow.spawn_stage]")
+{
+    std::vector<std::string> strs{"1", "2", "3", "4", "5"};
+
+    auto sum = flow::from(strs)
+                   .spawn_stage(2)
+                   .map([](std::string const& s) { return std::stoi(s); })
+                   .spawn_stage(2)
+                   .sum();
+
+    REQUIRE(sum == 15);
+}
+
+TEST_CASE("spawn_stage() forwards exceptions", "[flow.spawn_stage]")
+{
+    auto f = flow::ints(0, 100)
+                 .map([](int i) {
+                     if (i == 50) {
+                         throw std::runtime_error("bad item");
+                     }
+                     return i;
+                 })
+                 .spawn_stage(8);
+
+    int count = 0;
+    REQUIRE_THROWS_AS(f.for_each([&](int) { ++count; }), std::runtime_error);
+    // Everything produced before the exception was received
+    REQUIRE(count == 50);
+}
+
+TEST_CASE("spawn_stage() cancels upstream when downstream stops early", "[flow.spawn_stage]")
+{
+    std::atomic<int> produced{0};
+
+    {
+        auto f = flow::iota(0)
+                     .inspect([&](int) { ++produced; })
+                     .spawn_stage(16);
+        REQUIRE(f.any([](int i) { return i == 10; }));
+    }
+    // The infinite upstream stopped once the stage was destroyed
+    const int after = produced.load();
+    REQUIRE(after >= 11);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(produced.load() == after);
+
+    REQUIRE(flow::iota(0).spawn_stage(8).take(5).to_vector() ==
+            std::vector{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("spawn_stage() producer sleeps while downstream pauses", "[flow.spawn_stage]")
+{
+    auto f = flow::iota(0).spawn_stage(16);
+    REQUIRE(f.next().value() == 0);
+
+    // The producer soon fills the buffer, and must then wait for us without
+    // using the CPU. std::clock() measures the whole process's CPU time.
+    const std::clock_t start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const double cpu_ms = 1000.0 * double(std::clock() - start) / CLOCKS_PER_SEC;
+    REQUIRE(cpu_ms < 200);
+
+    REQUIRE(std::move(f).take(3).to_vector() == std::vector{1, 2, 3});
+}
+
+}
@@ -0,0 +1,100 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST_CASE("tee() of a single-pass flow", "[flow.tee]")
+{
+    std::istringstream iss("1 2 3 4 5");
+    auto readers = flow::from_istream<int>(iss).tee(2);
+    REQUIRE(readers.size() == 2);
+
+    // With the default spill policy, readers may be consumed one at a time
+    REQUIRE(std::move(readers[0]).to_vector() == std::vector{1, 2, 3, 4, 5});
+    REQUIRE(std::move(readers[1]).sum() == 15);
+}
+
+TEST_CASE("tee() readers may be interleaved", "[flow.tee]")
+{
+    auto readers = flow::tee(flow::ints(0, 1000), 3, flow::tee_policy::block, 2);
+
+    // zip() pulls from each reader in turn, so a tiny bounded buffer suffices
+    auto vec = flow::zip(std::move(readers[0]), std::move(readers[1]),
+                         std::move(readers[2]))
+                   .map([](auto t) {
+                       auto [a, b, c] = t;
+                       return a + b + c;
+                   })
+                   .to_vector();
+
+    REQUIRE(vec.size() == 1000);
+    REQUIRE(vec[999] == 2997);
+}
+
+TEST_CASE("tee() moves items to the last reader", "[flow.tee]")
+{
+    auto make_ptrs = flow::ints(0, 3).map([](int i) {
+        return std::make_shared<int>(i);
+    });
+    auto readers = std::move(make_ptrs).tee(2);
+
+    auto a = std::move(readers[0]).to_vector();
+    auto b = std::move(readers[1]).to_vector();
+
+    REQUIRE(a.size() == 3);
+    for (std::size_t i = 0; i < 3; i++) {
+        // Both readers share each object, and nothing else refers to it
+        REQUIRE(a[i] == b[i]);
+        REQUIRE(a[i].use_count() == 2);
+    }
+}
+
+TEST_CASE("Destroying a tee() reader releases its items", "[flow.tee]")
+{
+    auto readers = flow::iota(0).tee(2, flow::tee_policy::block, 4);
+    REQUIRE(readers[1].next().value() == 0);
+    readers.pop_back();
+
+    // If the second reader still held the buffer, this would block forever
+    auto vec = std::move(readers[0]).take(100).to_vector();
+    REQUIRE(vec.size() == 100);
+    REQUIRE(vec.back() == 99);
+}
+
+TEST_CASE("tee() readers on separate threads", "[flow.tee]")
+{
+    constexpr int count = 100'000;
+    auto readers = flow::ints(0, count)
+                       .map([](int i) { return std::to_string(i); })
+                       .tee(3, flow::tee_policy::block, 64);
+
+    std::vector<long long> sums(readers.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < readers.size(); i++) {
+        threads.emplace_back([&sums, i, r = std::move(readers[i])]() mutable {
+            sums[i] = std::move(r)
+                          .map([](std::string const& s) { return std::stoll(s); })
+                          .sum();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const long long expected = (long long) count * (count - 1) / 2;
+    REQUIRE(sums == std::vector<long long>(3, expected));
+}
+
+}
@@ -17,6 +17,12 @@ TEST_CASE("to_vector()", "[flow.to]")
     REQUIRE((vec == std::vector<int>{0, 1, 2, 3, 4}));
 }
 
+TEST_CASE("to_vector() (empty flow)", "[flow.to]")
+{
+    auto vec = flow::iota(0, 0).to_vector();
+    REQUIRE(vec.empty());
+}
+
 TEST_CASE("to_vector() (unique_ptr)", "[flow.to]")
 {
 
@@ -0,0 +1,178 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+template <typename Rng>
+using category_t = typename std::iterator_traits<
+    decltype(std::declval<Rng&>().begin())>::iterator_category;
+
+constexpr auto times_two = [](int i) { return i * 2; };
+
+using vec_t = std::vector<int>;
+
+static_assert(std::is_same_v<
+    category_t<decltype(flow::from(std::declval<vec_t&>()).map(times_two).to_range())>,
+    std::random_access_iterator_tag>);
+static_assert(std::is_same_v<
+    category_t<decltype(flow::from(std::declval<vec_t&>()).filter(flow::pred::odd).to_range())>,
+    std::forward_iterator_tag>);
+static_assert(std::is_same_v<
+    category_t<decltype(flow::from_istream<int>(std::declval<std::istream&>()).to_range())>,
+    std::input_iterator_tag>);
+
+constexpr bool test_ra_constexpr()
+{
+    int arr[] = {1, 2, 3, 4, 5};
+    auto rng = flow::map(arr, times_two).to_range();
+
+    if (rng.size() != 5 || rng.end() - rng.begin() != 5) {
+        return false;
+    }
+    if (rng.begin()[3] != 8 || *(rng.end() - 1) != 10) {
+        return false;
+    }
+    int sum = 0;
+    for (int i : rng) {
+        sum += i;
+    }
+    return sum == 30;
+}
+static_assert(test_ra_constexpr());
+
+TEST_CASE("to_range() of a random-access flow", "[flow.to_range]")
+{
+    const vec_t vec{1, 3, 5, 7, 9, 11};
+    auto rng = flow::from(vec).map(times_two).to_range();
+
+    REQUIRE(rng.size() == 6);
+    REQUIRE(std::distance(rng.begin(), rng.end()) == 6);
+    REQUIRE(std::is_sorted(rng.begin(), rng.end()));
+    REQUIRE(*std::lower_bound(rng.begin(), rng.end(), 14) == 14);
+    REQUIRE(std::lower_bound(rng.begin(), rng.end(), 13) - rng.begin() == 3);
+
+    std::vector<int> rev(std::make_reverse_iterator(rng.end()),
+                         std::make_reverse_iterator(rng.begin()));
+    REQUIRE(rev == vec_t{22, 18, 14, 10, 6, 2});
+}
+
+TEST_CASE("to_range() allows mutating algorithms", "[flow.to_range]")
+{
+    vec_t vec{0, 5, 4, 3, 2, 1, 0};
+    auto rng = flow::from(vec).drop(1).take(5).to_range();
+
+    std::sort(rng.begin(), rng.end());
+    REQUIRE(vec == vec_t{0, 1, 2, 3, 4, 5, 0});
+}
+
+TEST_CASE("to_range() of a multipass flow", "[flow.to_range]")
+{
+    const vec_t vec{1, 2, 3, 4, 5, 6, 7};
+    auto rng = flow::from(vec).filter(flow::pred::odd).to_range();
+
+    auto max = std::max_element(rng.begin(), rng.end());
+    REQUIRE(*max == 7);
+    REQUIRE(std::distance(rng.begin(), max) == 3);
+
+    // Iterators are independent of one another
+    auto first = rng.begin();
+    auto second = std::next(first);
+    REQUIRE(*first == 1);
+    REQUIRE(*second == 3);
+    first = second;
+    REQUIRE(first == second);
+    REQUIRE(*++first == 5);
+    REQUIRE(*second == 3);
+
+    REQUIRE(std::equal(rng.begin(), rng.end(), vec_t{1, 3, 5, 7}.begin()));
+}
+
+TEST_CASE("to_range() of a multipass flow supports operator->", "[flow.to_range]")
+{
+    std::vector<std::pair<int, int>> vec{{1, 2}, {3, 4}, {5, 6}};
+
+    auto rng = flow::from(vec).filter([](auto const& p) { return p.first > 1; }).to_range();
+    auto it = rng.begin();
+    REQUIRE(it->first == 3);
+    it->second = 40;
+    REQUIRE(vec[1].second == 40);
+}
+
+TEST_CASE("to_range() of a single-pass flow", "[flow.to_range]")
+{
+    std::istringstream iss("1 2 3");
+    auto rng = flow::from_istream<int>(iss).to_range();
+
+    REQUIRE(vec_t(rng.begin(), rng.end()) == vec_t{1, 2, 3});
+}
+
+TEST_CASE("to_vector() evaluates each item once", "[flow.to_range]")
+{
+    const vec_t vec{1, 2, 3, 4, 5};
+
+    int map_calls = 0;
+    auto mapped = flow::from(vec)
+                      .map([&](int i) { ++map_calls; return i * 2; })
+                      .to_vector();
+    REQUIRE(mapped == vec_t{2, 4, 6, 8, 10});
+    REQUIRE(map_calls == 5);
+
+    int filter_calls = 0;
+    auto filtered = flow::from(vec)
+                        .filter([&](int i) { ++filter_calls; return i % 2 == 1; })
+                        .to_vector();
+    REQUIRE(filtered == vec_t{1, 3, 5});
+    REQUIRE(filter_calls == 5);
+}
+
+TEST_CASE("to_range() of from() uses the source's own iterators", "[flow.to_range]")
+{
+    vec_t vec{1, 2, 3, 4, 5};
+
+    auto whole = flow::from(vec).to_range();
+    REQUIRE(whole.begin() == vec.begin());
+    REQUIRE(whole.end() == vec.end());
+
+    // After consuming from each end, only the rest of the source is exposed
+    auto f = flow::from(vec);
+    (void) f.next();
+    (void) f.next_back();
+    auto rest = std::move(f).to_range();
+    REQUIRE(rest.begin() == vec.begin() + 1);
+    REQUIRE(rest.end() == vec.end() - 1);
+
+    auto owned = flow::from(vec_t{1, 2, 3});
+    (void) owned.next();
+    REQUIRE(std::move(owned).to_range() == vec_t{2, 3});
+
+    auto arr = flow::from(std::array{1, 2, 3, 4});
+    (void) arr.next_back();
+    auto arr_rng = std::move(arr).to_range();
+    REQUIRE(vec_t(arr_rng.begin(), arr_rng.end()) == vec_t{1, 2, 3});
+}
+
+TEST_CASE("to() of from() with the source type", "[flow.to_range]")
+{
+    auto arr = flow::from(std::array{1, 2, 3, 4});
+    (void) arr.next();
+    (void) arr.next_back();
+    REQUIRE(std::move(arr).to<std::array<int, 4>>() == std::array{2, 3, 0, 0});
+
+    auto vec = flow::from(vec_t{1, 2, 3, 4});
+    (void) vec.next();
+    REQUIRE(std::move(vec).to<vec_t>() == vec_t{2, 3, 4});
+}
+
+}
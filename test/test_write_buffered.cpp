@@ -0,0 +1,172 @@
+
+// Copyright (c) 2022 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <flow.hpp>
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Reads back everything written to a temporary file
+auto read_all(std::FILE* file) -> std::string
+{
+    std::fflush(file);
+    std::rewind(file);
+    std::string out;
+    char buf[4096];
+    while (auto n = std::fread(buf, 1, sizeof(buf), file)) {
+        out.append(buf, n);
+    }
+    return out;
+}
+
+TEST_CASE("write_buffered() to a streambuf", "[flow.write_buffered]")
+{
+    std::ostringstream oss;
+
+    bool ok = flow::of{1, 2, 3, 4, 5}.filter(flow::pred::odd)
+                  .write_buffered(*oss.rdbuf());
+
+    CHECK(ok);
+    CHECK(oss.str() == "1, 3, 5");
+}
+
+TEST_CASE("write_buffered() formatting", "[flow.write_buffered]")
+{
+    std::ostringstream oss;
+
+    SECTION("floating point values are written in shortest form") {
+        flow::write_buffered(std::vector{0.5, -1.25, 1e100}, *oss.rdbuf(), ' ');
+        CHECK(oss.str() == "0.5 -1.25 1e+100");
+    }
+
+    SECTION("characters and bools") {
+        flow::write_buffered(std::string_view("abc"), *oss.rdbuf(), '-');
+        flow::of(true, false).write_buffered(*oss.rdbuf(), "");
+        CHECK(oss.str() == "a-b-c10");
+    }
+
+    SECTION("strings, with numeric separators") {
+        std::vector<std::string> words{"hello", "", "world"};
+        flow::write_buffered(words, *oss.rdbuf(), 0);
+        CHECK(oss.str() == "hello00world");
+    }
+
+    SECTION("empty flows write nothing") {
+        CHECK(flow::empty<int>().write_buffered(*oss.rdbuf()));
+        CHECK(oss.str().empty());
+    }
+}
+
+TEST_CASE("write_buffered() with more than one buffer of output", "[flow.write_buffered]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+
+    const std::string big(100'000, 'x');
+
+    CHECK(flow::ints(0, 50'000).write_buffered(file, '\n'));
+    CHECK(flow::of(std::string_view(big)).write_buffered(file));
+
+    std::ostringstream expected;
+    flow::ints(0, 50'000).write_to(expected, '\n');
+    expected << big;
+
+    CHECK(read_all(file) == expected.str());
+    std::fclose(file);
+}
+
+#ifdef FLOW_HAVE_POSIX_IO
+
+TEST_CASE("write_buffered() to a file descriptor", "[flow.write_buffered]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+
+    CHECK(flow::ints(0, 20'000).map([](auto i) { return i * 0.5; })
+              .write_buffered(fileno(file), ','));
+
+    std::ostringstream expected;
+    flow::ints(0, 20'000).map([](auto i) { return i * 0.5; }).write_to(expected, ',');
+
+    CHECK(read_all(file) == expected.str());
+    std::fclose(file);
+
+    CHECK_FALSE(flow::of(1, 2, 3).write_buffered(-1));
+}
+
+TEST_CASE("writev_to()", "[flow.write_buffered]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+
+    // Enough items to need several calls to writev()
+    std::vector<std::string> lines;
+    for (int i = 0; i < 2000; i++) {
+        lines.push_back("line " + std::to_string(i));
+    }
+
+    CHECK(flow::writev_to(lines, fileno(file), '\n'));
+    CHECK(flow::of(std::string_view("tail")).writev_to(fileno(file), ""));
+
+    std::ostringstream expected;
+    flow::write_to(lines, expected, '\n');
+    expected << "tail";
+
+    CHECK(read_all(file) == expected.str());
+    std::fclose(file);
+}
+
+TEST_CASE("writev_to() with views into a refilled buffer", "[flow.write_buffered]")
+{
+    // Far more lines than fit in from_lines()' read window, so the views it
+    // returns are invalidated many times over during the write
+    std::FILE* in = std::tmpfile();
+    REQUIRE(in != nullptr);
+    std::string expected;
+    for (int i = 0; i < 200'000; i++) {
+        char line[32];
+        std::snprintf(line, sizeof(line), "line-%06d\n", i);
+        expected += line;
+    }
+    REQUIRE(std::fwrite(expected.data(), 1, expected.size(), in) == expected.size());
+    std::rewind(in);
+
+    std::FILE* out = std::tmpfile();
+    REQUIRE(out != nullptr);
+
+    CHECK(flow::from_lines(in).writev_to(fileno(out), '\n'));
+    CHECK(read_all(out) + '\n' == expected);
+    std::fclose(out);
+    std::fclose(in);
+}
+
+TEST_CASE("writev_to() with by-value views larger than the staging buffer", "[flow.write_buffered]")
+{
+    const std::string big(100'000, 'x');
+    const std::string small = "abc";
+
+    std::FILE* out = std::tmpfile();
+    REQUIRE(out != nullptr);
+
+    auto f = flow::ints(0, 6).map([&](auto i) {
+        return std::string_view(i % 2 == 0 ? small : big);
+    });
+    CHECK(std::move(f).writev_to(fileno(out), "|"));
+
+    const std::string part = small + '|' + big;
+    CHECK(read_all(out) == part + '|' + part + '|' + part);
+    std::fclose(out);
+}
+
+#endif
+
+}
@@ -118,4 +118,62 @@ TEST_CASE("zip_with", "[flow.zip_with]")
     REQUIRE(out == "bccddd");
 }
 
+
+constexpr bool test_zip_with_indexed_try_fold()
+{
+    std::array a{1, 2, 3, 4, 5};
+    std::array const b{10, 20, 30};
+
+    {
+        auto f = flow::zip_with(std::plus<>{}, a, b);
+        if (f.sum() != 66) {
+            return false;
+        }
+    }
+
+    // Resuming after an early exit
+    {
+        auto f = flow::zip_with(std::plus<>{}, a, b);
+        int count = 0;
+        (void) f.try_for_each([&count](auto) { return ++count < 2; });
+        if (f.size() != 1 || f.next().value() != 33 || f.next()) {
+            return false;
+        }
+    }
+
+    // Three flows, including an unbounded iota
+    {
+        auto f = flow::zip_with([](int x, int y, long i) { return x * y + i; },
+                                a, b, flow::ints(100));
+        (void) f.next();
+        if (f.sum() != 40 + 101 + 90 + 102) {
+            return false;
+        }
+    }
+
+    return true;
+}
+static_assert(test_zip_with_indexed_try_fold());
+
+TEST_CASE("zip_with of contiguous flows", "[flow.zip_with]")
+{
+    std::vector<int> a{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<int> b{9, 8, 7, 6, 5, 4, 3, 2, 1, 0, -1};
+    std::vector<int> out(a.size());
+
+    auto end = flow::zip_with(std::plus<>{}, a, b).output_to(out.data());
+    REQUIRE(end == out.data() + out.size());
+    REQUIRE(out == std::vector<int>(9, 10));
+
+    // enumerate() counts correctly across try_fold() and next()
+    auto e = flow::enumerate(a);
+    (void) e.try_for_each([](auto m) { return m->first < 3; });
+    auto m = e.next();
+    REQUIRE(m.has_value());
+    REQUIRE(m->first == 4);
+    REQUIRE(m->second == 5);
+    REQUIRE(std::move(e).map([](auto p) { return p.first * p.second; }).sum() ==
+            5 * 6 + 6 * 7 + 7 * 8 + 8 * 9);
+}
+
 }